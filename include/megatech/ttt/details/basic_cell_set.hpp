@@ -0,0 +1,390 @@
+/**
+ * @file basic_cell_set.hpp
+ * @brief Arbitrarily sized game board cell set object.
+ * @author Alexander Rothman <gnomesort@megate.ch>
+ * @date 2024
+ * @copyright AGPL-3.0+
+ */
+#ifndef MEGATECH_TTT_DETAILS_BASIC_CELL_SET_HPP
+#define MEGATECH_TTT_DETAILS_BASIC_CELL_SET_HPP
+
+#include <cstddef>
+#include <cinttypes>
+
+#include <bit>
+#include <array>
+#include <iterator>
+
+namespace megatech::ttt::details {
+
+  /**
+   * @brief A set of game board cells stored as a multi-word mask.
+   * @details This is the counterpart of cell_set for boards with any number of cells. Bit i of the mask is set when
+   *          cell i is a member of the set. Iterating over a basic_cell_set yields the index of each member in
+   *          ascending order without allocating any memory.
+   * @tparam Cells The number of cells on the game board.
+   */
+  template <std::size_t Cells>
+  class basic_cell_set final {
+  public:
+    static_assert(Cells > 0, "A game board must have at least one cell.");
+
+    /**
+     * @brief The type of each word of the mask.
+     */
+    using word_type = std::uint64_t;
+
+    /**
+     * @brief The number of bits in each word of the mask.
+     */
+    static constexpr std::size_t WORD_BITS{ 64 };
+
+    /**
+     * @brief The number of words in the mask.
+     */
+    static constexpr std::size_t WORDS{ (Cells + WORD_BITS - 1) / WORD_BITS };
+
+    /**
+     * @brief A forward iterator over the members of a basic_cell_set.
+     */
+    class iterator final {
+    private:
+      std::array<word_type, WORDS> m_remaining{ };
+      std::size_t m_word{ WORDS };
+
+      constexpr void skip_empty_words();
+    public:
+      /**
+       * @brief The type of difference between iterators.
+       */
+      using difference_type = std::ptrdiff_t;
+
+      /**
+       * @brief The type of values produced by the iterator.
+       */
+      using value_type = std::size_t;
+
+      /**
+       * @brief Create a default initialized iterator.
+       * @details A default initialized iterator is equivalent to the end of any basic_cell_set.
+       */
+      constexpr iterator() = default;
+
+      /**
+       * @brief Create an iterator over the members of a mask.
+       * @param remaining The mask of members that have not yet been visited.
+       */
+      constexpr explicit iterator(const std::array<word_type, WORDS>& remaining);
+
+      /**
+       * @brief Retrieve the index of the current member.
+       * @return The index of the lowest unvisited member.
+       */
+      constexpr std::size_t operator*() const;
+
+      /**
+       * @brief Advance to the next member.
+       * @return A reference to the iterator.
+       */
+      constexpr iterator& operator++();
+
+      /**
+       * @brief Advance to the next member.
+       * @return A copy of the iterator before it was advanced.
+       */
+      constexpr iterator operator++(int);
+
+      /**
+       * @brief Compare two iterators for equality.
+       * @param rhs The iterator to compare to.
+       * @return True if both iterators have the same members left to visit. False in all other cases.
+       */
+      constexpr bool operator==(const iterator& rhs) const = default;
+    };
+  private:
+    // The bits of the final word that correspond to cells.
+    static constexpr word_type LAST_WORD_MASK{ Cells % WORD_BITS ? (word_type{ 1 } << (Cells % WORD_BITS)) - 1 :
+                                                                    ~word_type{ 0 } };
+
+    std::array<word_type, WORDS> m_words{ };
+  public:
+    /**
+     * @brief Create an empty basic_cell_set.
+     */
+    constexpr basic_cell_set() = default;
+
+    /**
+     * @brief Create a basic_cell_set from the words of a mask.
+     * @param words The mask of cells. Bits beyond the last cell are discarded.
+     */
+    constexpr explicit basic_cell_set(const std::array<word_type, WORDS>& words);
+
+    /**
+     * @brief Create a basic_cell_set containing every cell on the game board.
+     * @return A full set.
+     */
+    static constexpr basic_cell_set all();
+
+    /**
+     * @brief Retrieve the words of the mask.
+     * @return A reference to the words. Word i holds cells (i * WORD_BITS) through ((i + 1) * WORD_BITS) - 1.
+     */
+    constexpr const std::array<word_type, WORDS>& words() const;
+
+    /**
+     * @brief Determine if the set has no members.
+     * @return True if the set is empty. False in all other cases.
+     */
+    constexpr bool empty() const;
+
+    /**
+     * @brief Determine the number of members in the set.
+     * @return The count of cells in the set.
+     */
+    constexpr std::size_t size() const;
+
+    /**
+     * @brief Determine if a cell is a member of the set.
+     * @param index The index of the cell.
+     * @return True if the cell is a member of the set. False in all other cases.
+     */
+    constexpr bool contains(const std::size_t index) const;
+
+    /**
+     * @brief Determine if every member of another set is also a member of this set.
+     * @param other The set to compare to.
+     * @return True if this set is a superset of other. False in all other cases.
+     */
+    constexpr bool contains_all(const basic_cell_set& other) const;
+
+    /**
+     * @brief Determine if this set and another set have any members in common.
+     * @param other The set to compare to.
+     * @return True if at least one cell is a member of both sets. False in all other cases.
+     */
+    constexpr bool intersects(const basic_cell_set& other) const;
+
+    /**
+     * @brief Add a cell to the set.
+     * @param index The index of the cell. Indices greater than or equal to Cells are ignored.
+     */
+    constexpr void insert(const std::size_t index);
+
+    /**
+     * @brief Remove a cell from the set.
+     * @param index The index of the cell. Indices greater than or equal to Cells are ignored.
+     */
+    constexpr void erase(const std::size_t index);
+
+    /**
+     * @brief Compute the intersection of two sets.
+     * @param rhs The set to intersect with.
+     * @return A set of the cells that are members of both sets.
+     */
+    constexpr basic_cell_set operator&(const basic_cell_set& rhs) const;
+
+    /**
+     * @brief Compute the union of two sets.
+     * @param rhs The set to combine with.
+     * @return A set of the cells that are members of either set.
+     */
+    constexpr basic_cell_set operator|(const basic_cell_set& rhs) const;
+
+    /**
+     * @brief Compute the complement of the set.
+     * @return A set of every cell on the game board that is not a member of this set.
+     */
+    constexpr basic_cell_set operator~() const;
+
+    /**
+     * @brief Compare two sets for equality.
+     * @param rhs The set to compare to.
+     * @return True if both sets have the same members. False in all other cases.
+     */
+    constexpr bool operator==(const basic_cell_set& rhs) const = default;
+
+    /**
+     * @brief Retrieve an iterator to the first member of the set.
+     * @return An iterator to the lowest indexed member.
+     */
+    constexpr iterator begin() const;
+
+    /**
+     * @brief Retrieve an iterator past the last member of the set.
+     * @return An iterator that compares equal to an exhausted iterator.
+     */
+    constexpr iterator end() const;
+  };
+
+  template <std::size_t Cells>
+  constexpr void basic_cell_set<Cells>::iterator::skip_empty_words() {
+    while (m_word < WORDS && !m_remaining[m_word])
+    {
+      ++m_word;
+    }
+    // Exhausted iterators always compare equal to the end.
+    if (m_word == WORDS)
+    {
+      m_remaining = { };
+    }
+  }
+
+  template <std::size_t Cells>
+  constexpr basic_cell_set<Cells>::iterator::iterator(const std::array<word_type, WORDS>& remaining) :
+  m_remaining{ remaining }, m_word{ 0 } {
+    skip_empty_words();
+  }
+
+  template <std::size_t Cells>
+  constexpr std::size_t basic_cell_set<Cells>::iterator::operator*() const {
+    return m_word * WORD_BITS + std::countr_zero(m_remaining[m_word]);
+  }
+
+  template <std::size_t Cells>
+  constexpr typename basic_cell_set<Cells>::iterator& basic_cell_set<Cells>::iterator::operator++() {
+    // Clear the lowest set bit.
+    m_remaining[m_word] &= m_remaining[m_word] - 1;
+    skip_empty_words();
+    return *this;
+  }
+
+  template <std::size_t Cells>
+  constexpr typename basic_cell_set<Cells>::iterator basic_cell_set<Cells>::iterator::operator++(int) {
+    auto res = *this;
+    ++(*this);
+    return res;
+  }
+
+  template <std::size_t Cells>
+  constexpr basic_cell_set<Cells>::basic_cell_set(const std::array<word_type, WORDS>& words) : m_words{ words } {
+    m_words[WORDS - 1] &= LAST_WORD_MASK;
+  }
+
+  template <std::size_t Cells>
+  constexpr basic_cell_set<Cells> basic_cell_set<Cells>::all() {
+    auto res = basic_cell_set{ };
+    for (auto& word : res.m_words)
+    {
+      word = ~word_type{ 0 };
+    }
+    res.m_words[WORDS - 1] = LAST_WORD_MASK;
+    return res;
+  }
+
+  template <std::size_t Cells>
+  constexpr const std::array<typename basic_cell_set<Cells>::word_type, basic_cell_set<Cells>::WORDS>&
+  basic_cell_set<Cells>::words() const {
+    return m_words;
+  }
+
+  template <std::size_t Cells>
+  constexpr bool basic_cell_set<Cells>::empty() const {
+    for (const auto word : m_words)
+    {
+      if (word)
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  template <std::size_t Cells>
+  constexpr std::size_t basic_cell_set<Cells>::size() const {
+    auto res = std::size_t{ 0 };
+    for (const auto word : m_words)
+    {
+      res += std::popcount(word);
+    }
+    return res;
+  }
+
+  template <std::size_t Cells>
+  constexpr bool basic_cell_set<Cells>::contains(const std::size_t index) const {
+    return index < Cells && (m_words[index / WORD_BITS] & (word_type{ 1 } << (index % WORD_BITS)));
+  }
+
+  template <std::size_t Cells>
+  constexpr bool basic_cell_set<Cells>::contains_all(const basic_cell_set& other) const {
+    for (auto i = std::size_t{ 0 }; i < WORDS; ++i)
+    {
+      if ((m_words[i] & other.m_words[i]) != other.m_words[i])
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  template <std::size_t Cells>
+  constexpr bool basic_cell_set<Cells>::intersects(const basic_cell_set& other) const {
+    for (auto i = std::size_t{ 0 }; i < WORDS; ++i)
+    {
+      if (m_words[i] & other.m_words[i])
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  template <std::size_t Cells>
+  constexpr void basic_cell_set<Cells>::insert(const std::size_t index) {
+    if (index < Cells)
+    {
+      m_words[index / WORD_BITS] |= word_type{ 1 } << (index % WORD_BITS);
+    }
+  }
+
+  template <std::size_t Cells>
+  constexpr void basic_cell_set<Cells>::erase(const std::size_t index) {
+    if (index < Cells)
+    {
+      m_words[index / WORD_BITS] &= ~(word_type{ 1 } << (index % WORD_BITS));
+    }
+  }
+
+  template <std::size_t Cells>
+  constexpr basic_cell_set<Cells> basic_cell_set<Cells>::operator&(const basic_cell_set& rhs) const {
+    auto res = *this;
+    for (auto i = std::size_t{ 0 }; i < WORDS; ++i)
+    {
+      res.m_words[i] &= rhs.m_words[i];
+    }
+    return res;
+  }
+
+  template <std::size_t Cells>
+  constexpr basic_cell_set<Cells> basic_cell_set<Cells>::operator|(const basic_cell_set& rhs) const {
+    auto res = *this;
+    for (auto i = std::size_t{ 0 }; i < WORDS; ++i)
+    {
+      res.m_words[i] |= rhs.m_words[i];
+    }
+    return res;
+  }
+
+  template <std::size_t Cells>
+  constexpr basic_cell_set<Cells> basic_cell_set<Cells>::operator~() const {
+    auto res = *this;
+    for (auto& word : res.m_words)
+    {
+      word = ~word;
+    }
+    res.m_words[WORDS - 1] &= LAST_WORD_MASK;
+    return res;
+  }
+
+  template <std::size_t Cells>
+  constexpr typename basic_cell_set<Cells>::iterator basic_cell_set<Cells>::begin() const {
+    return iterator{ m_words };
+  }
+
+  template <std::size_t Cells>
+  constexpr typename basic_cell_set<Cells>::iterator basic_cell_set<Cells>::end() const {
+    return iterator{ };
+  }
+
+}
+
+#endif
@@ -0,0 +1,896 @@
+/**
+ * @file basic_state.hpp
+ * @brief Generalized m,n,k game state object.
+ * @author Alexander Rothman <gnomesort@megate.ch>
+ * @date 2024
+ * @copyright AGPL-3.0+
+ */
+#ifndef MEGATECH_TTT_DETAILS_BASIC_STATE_HPP
+#define MEGATECH_TTT_DETAILS_BASIC_STATE_HPP
+
+#include <cstddef>
+#include <cinttypes>
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include <utility>
+
+#include "../enums.hpp"
+
+#include "basic_cell_set.hpp"
+
+namespace megatech::ttt::details {
+
+  /**
+   * @brief The symmetries of a square game board.
+   * @details These are the 8 rotations and reflections of a square. Rotations are clockwise. The positions below are
+   *          given for the standard 3x3 board. On larger square boards, 2 is replaced by the largest index.
+   */
+  enum class symmetry : std::uint32_t {
+    /**
+     * @brief The transformation that leaves every cell in place.
+     */
+    identity = 0,
+
+    /**
+     * @brief A quarter turn. The cell at (column, row) moves to (2 - row, column).
+     */
+    rotate_90 = 1,
+
+    /**
+     * @brief A half turn. The cell at (column, row) moves to (2 - column, 2 - row).
+     */
+    rotate_180 = 2,
+
+    /**
+     * @brief A three quarter turn. The cell at (column, row) moves to (row, 2 - column).
+     */
+    rotate_270 = 3,
+
+    /**
+     * @brief A reflection across the center column. The cell at (column, row) moves to (2 - column, row).
+     */
+    reflect_horizontal = 4,
+
+    /**
+     * @brief A reflection across the middle row. The cell at (column, row) moves to (column, 2 - row).
+     */
+    reflect_vertical = 5,
+
+    /**
+     * @brief A reflection across the left-to-right diagonal. The cell at (column, row) moves to (row, column).
+     */
+    reflect_left_diagonal = 6,
+
+    /**
+     * @brief A reflection across the right-to-left diagonal. The cell at (column, row) moves to
+     *        (2 - row, 2 - column).
+     */
+    reflect_right_diagonal = 7
+  };
+
+  /**
+   * @brief Determine the symmetry that undoes another.
+   * @param sym The symmetry to invert.
+   * @return The symmetry that returns every cell moved by sym to its original position.
+   * @throw std::runtime_error If the symmetry is ill formed.
+   */
+  symmetry inverse(const symmetry sym);
+
+  /**
+   * @brief A game state for an m,n,k-game.
+   * @details An m,n,k-game is played on a board with Columns columns and Rows rows. The first player to mark K
+   *          consecutive cells in a row, column, or diagonal wins. Each player's marks are stored as a separate
+   *          occupancy plane of Columns * Rows bits. Cell (column, row) has the index (row * Columns) + column.
+   *
+   *          Every line of K cells is generated at compile time. Win checks compare the planes against these masks
+   *          and completes_line() only visits the lines through a single cell.
+   *
+   *          The standard 3x3 game is the specialization basic_state<3, 3, 3>, which is also named state. That
+   *          specialization keeps the packed 32-bit layout used by the data file and adds conversion to and from it.
+   *          The remaining query API is the same for every board size.
+   * @tparam Columns The number of columns on the game board.
+   * @tparam Rows The number of rows on the game board.
+   * @tparam K The number of consecutive marks required to win.
+   */
+  template <std::size_t Columns, std::size_t Rows, std::size_t K>
+  class basic_state final {
+  public:
+    static_assert(Columns > 0 && Rows > 0, "The game board must have at least one cell.");
+    static_assert(K > 0 && (K <= Columns || K <= Rows), "The winning line length must fit on the game board.");
+
+    /**
+     * @brief The number of columns on the game board.
+     */
+    static constexpr std::size_t COLUMNS{ Columns };
+
+    /**
+     * @brief The number of rows on the game board.
+     */
+    static constexpr std::size_t ROWS{ Rows };
+
+    /**
+     * @brief The number of cells on the game board.
+     */
+    static constexpr std::size_t CELLS{ Columns * Rows };
+
+    /**
+     * @brief The number of consecutive marks required to win.
+     */
+    static constexpr std::size_t LINE_LENGTH{ K };
+
+    /**
+     * @brief The type used to represent sets of cells.
+     */
+    using cell_set_type = basic_cell_set<CELLS>;
+  private:
+    static constexpr std::size_t span(const std::size_t extent) {
+      return extent >= K ? extent - K + 1 : 0;
+    }
+  public:
+    /**
+     * @brief The number of lines of K cells on the game board.
+     */
+    static constexpr std::size_t LINE_COUNT{ Rows * span(Columns) + Columns * span(Rows) +
+                                             2 * span(Columns) * span(Rows) };
+
+    /**
+     * @brief Retrieve every line of K cells on the game board.
+     * @details Lines are ordered by direction: rows, then columns, then left-to-right diagonals, and finally
+     *          right-to-left diagonals.
+     * @return A reference to the line masks.
+     */
+    static const std::array<cell_set_type, LINE_COUNT>& lines();
+  private:
+    // No cell can lie on more than K lines in each of the 4 directions.
+    static constexpr std::size_t MAX_CELL_LINES{ 4 * K };
+    static constexpr std::size_t SYMMETRY_COUNT{ 8 };
+
+    struct cell_lines final {
+      std::array<std::uint16_t, MAX_CELL_LINES> lines;
+      std::size_t count;
+    };
+
+    static_assert(LINE_COUNT < 0x1'00'00, "There are too many lines on the game board.");
+
+    cell_set_type m_x{ };
+    cell_set_type m_o{ };
+    std::uint64_t m_hash{ };
+    game_mode m_mode{ game_mode::single_player };
+    game_phase m_phase{ game_phase::turn_x };
+
+    static constexpr std::uint64_t splitmix64(std::uint64_t& x);
+    static constexpr std::array<cell_set_type, LINE_COUNT> generate_lines();
+    static constexpr std::array<cell_lines, CELLS> generate_cell_lines();
+    static constexpr std::array<std::array<std::uint64_t, 2>, CELLS> generate_zobrist_keys();
+    static constexpr std::size_t transform_index(const std::size_t sym, const std::size_t index);
+
+    static const std::array<cell_lines, CELLS>& lines_through();
+    static const std::array<std::array<std::uint64_t, 2>, CELLS>& zobrist_keys();
+
+    static void check_indices(const std::size_t column, const std::size_t row);
+    bool is_line(const std::size_t first, const std::size_t step, const std::size_t length,
+                 const cell_set_type& plane) const;
+  public:
+    /**
+     * @brief Create a default initialized state.
+     * @details The board is empty, the mode is single_player, and the phase is turn_x.
+     */
+    basic_state() = default;
+
+    /**
+     * @brief Create a state as a copy of another.
+     * @param other The state to copy.
+     */
+    basic_state(const basic_state& other) = default;
+
+    /**
+     * @brief Create a state by moving another.
+     * @param other The state to move.
+     */
+    basic_state(basic_state&& other) = default;
+
+    /**
+     * @brief Destroy a state.
+     */
+    ~basic_state() noexcept = default;
+
+    /**
+     * @brief Copy-assign a state.
+     * @param rhs The state to copy.
+     * @return A reference to the assigned state.
+     */
+    basic_state& operator=(const basic_state& rhs) = default;
+
+    /**
+     * @brief Move-assign a state.
+     * @param rhs The state to move.
+     * @return A reference to the assigned state.
+     */
+    basic_state& operator=(basic_state&& rhs) = default;
+
+    /**
+     * @brief Retrieve the current game mode.
+     * @return The game mode.
+     */
+    game_mode mode() const;
+
+    /**
+     * @brief Set the current game mode.
+     * @param gm The new game mode.
+     * @throw std::runtime_error If the game mode is invalid.
+     */
+    void mode(const game_mode gm);
+
+    /**
+     * @brief Retrieve the current game phase.
+     * @return The game phase.
+     */
+    game_phase phase() const;
+
+    /**
+     * @brief Set the current game phase.
+     * @param gp The new game phase.
+     * @throw std::runtime_error If the game phase is invalid.
+     */
+    void phase(const game_phase gp);
+
+    /**
+     * @brief Retrieve a hash of the game board.
+     * @details The hash is a Zobrist hash maintained incrementally as cells are marked. The mode and phase are
+     *          ignored. Boards are wider than in the 3x3 game so the hash is 64 bits wide.
+     * @return A 64-bit hash of the game board.
+     */
+    std::uint64_t hash() const;
+
+    /**
+     * @brief Determine if no cells on the game board are marked.
+     * @return True if the board is empty. False in all other cases.
+     */
+    bool is_board_empty() const;
+
+    /**
+     * @brief Determine if every cell on the game board is marked.
+     * @return True if the board is full. False in all other cases.
+     */
+    bool is_board_full() const;
+
+    /**
+     * @brief Determine if the given row is marked with all X's.
+     * @param row The row to query.
+     * @return True if the given row is marked with all X's. False in all other cases.
+     * @throw std::runtime_error If the row index is out of range.
+     */
+    bool is_row_x(const std::size_t row) const;
+
+    /**
+     * @brief Determine if the given row is marked with all O's.
+     * @param row The row to query.
+     * @return True if the given row is marked with all O's. False in all other cases.
+     * @throw std::runtime_error If the row index is out of range.
+     */
+    bool is_row_o(const std::size_t row) const;
+
+    /**
+     * @brief Determine if the given column is marked with all X's.
+     * @param column The column to query.
+     * @return True if the given column is marked with all X's. False in all other cases.
+     * @throw std::runtime_error If the column index is out of range.
+     */
+    bool is_column_x(const std::size_t column) const;
+
+    /**
+     * @brief Determine if the given column is marked with all O's.
+     * @param column The column to query.
+     * @return True if the given column is marked with all O's. False in all other cases.
+     * @throw std::runtime_error If the column index is out of range.
+     */
+    bool is_column_o(const std::size_t column) const;
+
+    /**
+     * @brief Determine if the left-to-right game board diagonal is marked with all X's
+     * @details The diagonal begins at the upper left cell and continues for min(Columns, Rows) cells.
+     * @return True if the left-to-right diagonal is marked with all X's. False in all other cases.
+     */
+    bool is_left_diagonal_x() const;
+
+    /**
+     * @brief Determine if the left-to-right game board diagonal is marked with all O's
+     * @details The diagonal begins at the upper left cell and continues for min(Columns, Rows) cells.
+     * @return True if the left-to-right diagonal is marked with all O's. False in all other cases.
+     */
+    bool is_left_diagonal_o() const;
+
+    /**
+     * @brief Determine if the right-to-left game board diagonal is marked with all X's
+     * @details The diagonal begins at the upper right cell and continues for min(Columns, Rows) cells.
+     * @return True if the right-to-left diagonal is marked with all X's. False in all other cases.
+     */
+    bool is_right_diagonal_x() const;
+
+    /**
+     * @brief Determine if the right-to-left game board diagonal is marked with all O's
+     * @details The diagonal begins at the upper right cell and continues for min(Columns, Rows) cells.
+     * @return True if the right-to-left diagonal is marked with all O's. False in all other cases.
+     */
+    bool is_right_diagonal_o() const;
+
+    /**
+     * @brief Determine which player, if any, has marked K consecutive cells.
+     * @return cell_contents::x if X has marked a winning line. cell_contents::o if O has marked a winning line.
+     *         cell_contents::empty in all other cases.
+     */
+    cell_contents winner() const;
+
+    /**
+     * @brief Determine if marking the given cell would complete a line of K cells.
+     * @details Only the lines passing through the given cell are checked. The cell may already contain the given
+     *          value, in which case this determines whether the existing mark is part of a complete line. The state
+     *          itself is not modified.
+     * @param column The column index of the cell.
+     * @param row The row index of the cell.
+     * @param value The value to consider the cell marked with.
+     * @return True if every cell of at least one line through (column, row) would be marked with value. False in all
+     *         other cases, including when value is cell_contents::empty.
+     * @throw std::runtime_error If the column or row index is out of range.
+     */
+    bool completes_line(const std::size_t column, const std::size_t row, const cell_contents value) const;
+
+    /**
+     * @brief Determine if the given cell is unmarked.
+     * @param column The column index of the cell.
+     * @param row The row index of the cell.
+     * @return True if the cell at (column, row) is unmarked. False in all other cases.
+     * @throw std::runtime_error If the column or row index is out of range.
+     */
+    bool is_cell_empty(const std::size_t column, const std::size_t row) const;
+
+    /**
+     * @brief Determine if the given cell is marked with an X.
+     * @param column The column index of the cell.
+     * @param row The row index of the cell.
+     * @return True if the cell at (column, row) is marked with an X. False in all other cases.
+     * @throw std::runtime_error If the column or row index is out of range.
+     */
+    bool is_cell_x(const std::size_t column, const std::size_t row) const;
+
+    /**
+     * @brief Determine how many cells on the game board are marked.
+     * @return The count of marked cells.
+     */
+    std::size_t filled_cells() const;
+
+    /**
+     * @brief Determine how many cells on the game board are marked with an X.
+     * @return The count of marked cells.
+     */
+    std::size_t count_x() const;
+
+    /**
+     * @brief Determine how many cells on the game board are marked with an O.
+     * @return The count of marked cells.
+     */
+    std::size_t count_o() const;
+
+    /**
+     * @brief Retrieve the set of unmarked cells.
+     * @details This is the set of legal moves in any state that is still in play.
+     * @return A set containing every unmarked cell.
+     */
+    cell_set_type empty_cells() const;
+
+    /**
+     * @brief Retrieve the set of cells marked with an X.
+     * @return A set containing every cell marked with an X.
+     */
+    cell_set_type x_cells() const;
+
+    /**
+     * @brief Retrieve the set of cells marked with an O.
+     * @return A set containing every cell marked with an O.
+     */
+    cell_set_type o_cells() const;
+
+    /**
+     * @brief Apply a symmetry to the game board.
+     * @details This is only available for square boards. The mode and phase of the state are preserved.
+     * @param sym The symmetry to apply.
+     * @return A new state where every mark has been moved according to sym.
+     * @throw std::runtime_error If the symmetry is ill formed.
+     */
+    basic_state transformed(const symmetry sym) const requires (Columns == Rows);
+
+    /**
+     * @brief Find the canonical representative of the state among its symmetries.
+     * @details This is only available for square boards. Every state that can be reached from another by a rotation
+     *          or reflection has the same canonical state. The mode and phase of the state are preserved.
+     * @return A pair containing the canonical state and the symmetry that transforms this state into it.
+     */
+    std::pair<basic_state, symmetry> canonical() const requires (Columns == Rows);
+
+    /**
+     * @brief Query the content of the cell at the given position.
+     * @param column The column index of the cell.
+     * @param row The row index of the cell.
+     * @return The content of the desired cell.
+     * @throw std::runtime_error If the column or row index is out of range.
+     */
+    cell_contents cell(const std::size_t column, const std::size_t row) const;
+
+    /**
+     * @brief Query the content of the cell at a position known at compile time.
+     * @tparam Column The column index of the cell.
+     * @tparam Row The row index of the cell.
+     * @return The content of the desired cell.
+     */
+    template <std::size_t Column, std::size_t Row>
+    cell_contents cell() const;
+
+    /**
+     * @brief Query the content of the cell at the given position without checking the indices.
+     * @details This is intended for internal use with indices that are already known to be valid. Use cell() for any
+     *          external input.
+     * @param column The column index of the cell. This must be less than Columns.
+     * @param row The row index of the cell. This must be less than Rows.
+     * @return The content of the desired cell.
+     */
+    cell_contents unchecked_cell(const std::size_t column, const std::size_t row) const;
+
+    /**
+     * @brief Set the content of the cell at the given position.
+     * @param column The column index of the cell.
+     * @param row The row index of the cell.
+     * @param value The value to assign to the cell.
+     * @throw std::runtime_error If the column or row index is out of range or if the value is invalid.
+     */
+    void cell(const std::size_t column, const std::size_t row, const cell_contents value);
+  };
+
+  template <std::size_t Columns, std::size_t Rows, std::size_t K>
+  constexpr std::uint64_t basic_state<Columns, Rows, K>::splitmix64(std::uint64_t& x) {
+    auto z = (x += 0x9e'37'79'b9'7f'4a'7c'15);
+    z = (z ^ (z >> 30)) * 0xbf'58'47'6d'1c'e4'e5'b9;
+    z = (z ^ (z >> 27)) * 0x94'd0'49'bb'13'31'11'eb;
+    return z ^ (z >> 31);
+  }
+
+  template <std::size_t Columns, std::size_t Rows, std::size_t K>
+  constexpr std::array<typename basic_state<Columns, Rows, K>::cell_set_type,
+                       basic_state<Columns, Rows, K>::LINE_COUNT> basic_state<Columns, Rows, K>::generate_lines() {
+    // Lines are generated in the order rows, columns, left-to-right diagonals, and finally right-to-left diagonals.
+    // Each line is identified by its first cell and a step in each direction.
+    constexpr auto directions = std::array<std::array<std::ptrdiff_t, 2>, 4>{ { { 1, 0 }, { 0, 1 }, { 1, 1 },
+                                                                                { -1, 1 } } };
+    auto res = std::array<cell_set_type, LINE_COUNT>{ };
+    auto next = std::size_t{ 0 };
+    for (const auto& [dc, dr] : directions)
+    {
+      for (auto row = std::ptrdiff_t{ 0 }; row < static_cast<std::ptrdiff_t>(Rows); ++row)
+      {
+        for (auto column = std::ptrdiff_t{ 0 }; column < static_cast<std::ptrdiff_t>(Columns); ++column)
+        {
+          const auto last_column = column + dc * static_cast<std::ptrdiff_t>(K - 1);
+          const auto last_row = row + dr * static_cast<std::ptrdiff_t>(K - 1);
+          if (last_column < 0 || last_column >= static_cast<std::ptrdiff_t>(Columns) ||
+              last_row >= static_cast<std::ptrdiff_t>(Rows))
+          {
+            continue;
+          }
+          for (auto i = std::ptrdiff_t{ 0 }; i < static_cast<std::ptrdiff_t>(K); ++i)
+          {
+            res[next].insert((row + dr * i) * Columns + (column + dc * i));
+          }
+          ++next;
+        }
+      }
+    }
+    return res;
+  }
+
+  template <std::size_t Columns, std::size_t Rows, std::size_t K>
+  constexpr std::array<typename basic_state<Columns, Rows, K>::cell_lines, basic_state<Columns, Rows, K>::CELLS>
+  basic_state<Columns, Rows, K>::generate_cell_lines() {
+    const auto all_lines = generate_lines();
+    auto res = std::array<cell_lines, CELLS>{ };
+    for (auto line = std::size_t{ 0 }; line < LINE_COUNT; ++line)
+    {
+      for (const auto cell : all_lines[line])
+      {
+        res[cell].lines[res[cell].count++] = static_cast<std::uint16_t>(line);
+      }
+    }
+    return res;
+  }
+
+  template <std::size_t Columns, std::size_t Rows, std::size_t K>
+  constexpr std::array<std::array<std::uint64_t, 2>, basic_state<Columns, Rows, K>::CELLS>
+  basic_state<Columns, Rows, K>::generate_zobrist_keys() {
+    // One key for every cell and every mark. Empty cells contribute nothing so that the hash of an empty board is 0.
+    auto res = std::array<std::array<std::uint64_t, 2>, CELLS>{ };
+    auto seed = std::uint64_t{ 0x74'74'74'0d'0a'1a'0a'89 } ^ (Columns << 16) ^ (Rows << 8) ^ K;
+    for (auto& cell : res)
+    {
+      for (auto& key : cell)
+      {
+        key = splitmix64(seed);
+      }
+    }
+    return res;
+  }
+
+  template <std::size_t Columns, std::size_t Rows, std::size_t K>
+  constexpr std::size_t basic_state<Columns, Rows, K>::transform_index(const std::size_t sym,
+                                                                      const std::size_t index) {
+    constexpr auto last = Columns - 1;
+    const auto column = index % Columns;
+    const auto row = index / Columns;
+    switch (sym)
+    {
+    case 1:
+      return column * Columns + (last - row);
+    case 2:
+      return (last - row) * Columns + (last - column);
+    case 3:
+      return (last - column) * Columns + row;
+    case 4:
+      return row * Columns + (last - column);
+    case 5:
+      return (last - row) * Columns + column;
+    case 6:
+      return column * Columns + row;
+    case 7:
+      return (last - column) * Columns + (last - row);
+    default:
+      return index;
+    }
+  }
+
+  template <std::size_t Columns, std::size_t Rows, std::size_t K>
+  const std::array<typename basic_state<Columns, Rows, K>::cell_set_type, basic_state<Columns, Rows, K>::LINE_COUNT>&
+  basic_state<Columns, Rows, K>::lines() {
+    static constexpr auto res = generate_lines();
+    return res;
+  }
+
+  template <std::size_t Columns, std::size_t Rows, std::size_t K>
+  const std::array<typename basic_state<Columns, Rows, K>::cell_lines, basic_state<Columns, Rows, K>::CELLS>&
+  basic_state<Columns, Rows, K>::lines_through() {
+    static constexpr auto res = generate_cell_lines();
+    return res;
+  }
+
+  template <std::size_t Columns, std::size_t Rows, std::size_t K>
+  const std::array<std::array<std::uint64_t, 2>, basic_state<Columns, Rows, K>::CELLS>&
+  basic_state<Columns, Rows, K>::zobrist_keys() {
+    static constexpr auto res = generate_zobrist_keys();
+    return res;
+  }
+
+  template <std::size_t Columns, std::size_t Rows, std::size_t K>
+  void basic_state<Columns, Rows, K>::check_indices(const std::size_t column, const std::size_t row) {
+    if (column >= Columns)
+    {
+      throw std::runtime_error{ "The column index is out of bounds." };
+    }
+    if (row >= Rows)
+    {
+      throw std::runtime_error{ "The row index is out of bounds." };
+    }
+  }
+
+  template <std::size_t Columns, std::size_t Rows, std::size_t K>
+  bool basic_state<Columns, Rows, K>::is_line(const std::size_t first, const std::size_t step,
+                                              const std::size_t length, const cell_set_type& plane) const {
+    for (auto i = std::size_t{ 0 }, cell = first; i < length; ++i, cell += step)
+    {
+      if (!plane.contains(cell))
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  template <std::size_t Columns, std::size_t Rows, std::size_t K>
+  game_mode basic_state<Columns, Rows, K>::mode() const {
+    return m_mode;
+  }
+
+  template <std::size_t Columns, std::size_t Rows, std::size_t K>
+  void basic_state<Columns, Rows, K>::mode(const game_mode gm) {
+    if (gm != game_mode::single_player && gm != game_mode::multiplayer)
+    {
+      throw std::runtime_error{ "The game mode was invalid." };
+    }
+    m_mode = gm;
+  }
+
+  template <std::size_t Columns, std::size_t Rows, std::size_t K>
+  game_phase basic_state<Columns, Rows, K>::phase() const {
+    return m_phase;
+  }
+
+  template <std::size_t Columns, std::size_t Rows, std::size_t K>
+  void basic_state<Columns, Rows, K>::phase(const game_phase gp) {
+    const auto gp_bits = static_cast<std::uint32_t>(gp);
+    if (gp_bits > static_cast<std::uint32_t>(game_phase::draw) || (gp_bits & 0x0f'ff'ff'ff))
+    {
+      throw std::runtime_error{ "The game phase was invalid." };
+    }
+    m_phase = gp;
+  }
+
+  template <std::size_t Columns, std::size_t Rows, std::size_t K>
+  std::uint64_t basic_state<Columns, Rows, K>::hash() const {
+    // The murmur3 finalizer spreads every bit of the raw Zobrist hash across the output. See state::hash().
+    auto res = m_hash;
+    res ^= res >> 33;
+    res *= 0xff'51'af'd7'ed'55'8c'cd;
+    res ^= res >> 33;
+    res *= 0xc4'ce'b9'fe'1a'85'ec'53;
+    res ^= res >> 33;
+    return res;
+  }
+
+  template <std::size_t Columns, std::size_t Rows, std::size_t K>
+  bool basic_state<Columns, Rows, K>::is_board_empty() const {
+    return m_x.empty() && m_o.empty();
+  }
+
+  template <std::size_t Columns, std::size_t Rows, std::size_t K>
+  bool basic_state<Columns, Rows, K>::is_board_full() const {
+    return (m_x | m_o) == cell_set_type::all();
+  }
+
+  template <std::size_t Columns, std::size_t Rows, std::size_t K>
+  bool basic_state<Columns, Rows, K>::is_row_x(const std::size_t row) const {
+    check_indices(0, row);
+    return is_line(row * Columns, 1, Columns, m_x);
+  }
+
+  template <std::size_t Columns, std::size_t Rows, std::size_t K>
+  bool basic_state<Columns, Rows, K>::is_row_o(const std::size_t row) const {
+    check_indices(0, row);
+    return is_line(row * Columns, 1, Columns, m_o);
+  }
+
+  template <std::size_t Columns, std::size_t Rows, std::size_t K>
+  bool basic_state<Columns, Rows, K>::is_column_x(const std::size_t column) const {
+    check_indices(column, 0);
+    return is_line(column, Columns, Rows, m_x);
+  }
+
+  template <std::size_t Columns, std::size_t Rows, std::size_t K>
+  bool basic_state<Columns, Rows, K>::is_column_o(const std::size_t column) const {
+    check_indices(column, 0);
+    return is_line(column, Columns, Rows, m_o);
+  }
+
+  template <std::size_t Columns, std::size_t Rows, std::size_t K>
+  bool basic_state<Columns, Rows, K>::is_left_diagonal_x() const {
+    return is_line(0, Columns + 1, std::min(Columns, Rows), m_x);
+  }
+
+  template <std::size_t Columns, std::size_t Rows, std::size_t K>
+  bool basic_state<Columns, Rows, K>::is_left_diagonal_o() const {
+    return is_line(0, Columns + 1, std::min(Columns, Rows), m_o);
+  }
+
+  template <std::size_t Columns, std::size_t Rows, std::size_t K>
+  bool basic_state<Columns, Rows, K>::is_right_diagonal_x() const {
+    return is_line(Columns - 1, Columns - 1, std::min(Columns, Rows), m_x);
+  }
+
+  template <std::size_t Columns, std::size_t Rows, std::size_t K>
+  bool basic_state<Columns, Rows, K>::is_right_diagonal_o() const {
+    return is_line(Columns - 1, Columns - 1, std::min(Columns, Rows), m_o);
+  }
+
+  template <std::size_t Columns, std::size_t Rows, std::size_t K>
+  cell_contents basic_state<Columns, Rows, K>::winner() const {
+    for (const auto& line : lines())
+    {
+      if (m_x.contains_all(line))
+      {
+        return cell_contents::x;
+      }
+      if (m_o.contains_all(line))
+      {
+        return cell_contents::o;
+      }
+    }
+    return cell_contents::empty;
+  }
+
+  template <std::size_t Columns, std::size_t Rows, std::size_t K>
+  bool basic_state<Columns, Rows, K>::completes_line(const std::size_t column, const std::size_t row,
+                                                     const cell_contents value) const {
+    check_indices(column, row);
+    auto plane = cell_set_type{ };
+    switch (value)
+    {
+    case cell_contents::x:
+      plane = m_x;
+      break;
+    case cell_contents::o:
+      plane = m_o;
+      break;
+    default:
+      return false;
+    }
+    const auto index = row * Columns + column;
+    plane.insert(index);
+    const auto& through = lines_through()[index];
+    for (auto i = std::size_t{ 0 }; i < through.count; ++i)
+    {
+      if (plane.contains_all(lines()[through.lines[i]]))
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  template <std::size_t Columns, std::size_t Rows, std::size_t K>
+  bool basic_state<Columns, Rows, K>::is_cell_empty(const std::size_t column, const std::size_t row) const {
+    return cell(column, row) == cell_contents::empty;
+  }
+
+  template <std::size_t Columns, std::size_t Rows, std::size_t K>
+  bool basic_state<Columns, Rows, K>::is_cell_x(const std::size_t column, const std::size_t row) const {
+    return cell(column, row) == cell_contents::x;
+  }
+
+  template <std::size_t Columns, std::size_t Rows, std::size_t K>
+  std::size_t basic_state<Columns, Rows, K>::filled_cells() const {
+    return m_x.size() + m_o.size();
+  }
+
+  template <std::size_t Columns, std::size_t Rows, std::size_t K>
+  std::size_t basic_state<Columns, Rows, K>::count_x() const {
+    return m_x.size();
+  }
+
+  template <std::size_t Columns, std::size_t Rows, std::size_t K>
+  std::size_t basic_state<Columns, Rows, K>::count_o() const {
+    return m_o.size();
+  }
+
+  template <std::size_t Columns, std::size_t Rows, std::size_t K>
+  typename basic_state<Columns, Rows, K>::cell_set_type basic_state<Columns, Rows, K>::empty_cells() const {
+    return ~(m_x | m_o);
+  }
+
+  template <std::size_t Columns, std::size_t Rows, std::size_t K>
+  typename basic_state<Columns, Rows, K>::cell_set_type basic_state<Columns, Rows, K>::x_cells() const {
+    return m_x;
+  }
+
+  template <std::size_t Columns, std::size_t Rows, std::size_t K>
+  typename basic_state<Columns, Rows, K>::cell_set_type basic_state<Columns, Rows, K>::o_cells() const {
+    return m_o;
+  }
+
+  template <std::size_t Columns, std::size_t Rows, std::size_t K>
+  basic_state<Columns, Rows, K> basic_state<Columns, Rows, K>::transformed(const symmetry sym) const
+  requires (Columns == Rows) {
+    const auto sym_index = static_cast<std::size_t>(sym);
+    if (sym_index >= SYMMETRY_COUNT)
+    {
+      throw std::runtime_error{ "The symmetry was invalid." };
+    }
+    auto res = basic_state{ };
+    res.m_mode = m_mode;
+    res.m_phase = m_phase;
+    for (const auto cell : m_x)
+    {
+      const auto moved = transform_index(sym_index, cell);
+      res.m_x.insert(moved);
+      res.m_hash ^= zobrist_keys()[moved][0];
+    }
+    for (const auto cell : m_o)
+    {
+      const auto moved = transform_index(sym_index, cell);
+      res.m_o.insert(moved);
+      res.m_hash ^= zobrist_keys()[moved][1];
+    }
+    return res;
+  }
+
+  template <std::size_t Columns, std::size_t Rows, std::size_t K>
+  std::pair<basic_state<Columns, Rows, K>, symmetry> basic_state<Columns, Rows, K>::canonical() const
+  requires (Columns == Rows) {
+    // States are ordered by their O plane and then by their X plane, comparing the highest words first.
+    const auto less = [](const basic_state& a, const basic_state& b) {
+      for (auto i = cell_set_type::WORDS; i-- > 0;)
+      {
+        if (a.m_o.words()[i] != b.m_o.words()[i])
+        {
+          return a.m_o.words()[i] < b.m_o.words()[i];
+        }
+      }
+      for (auto i = cell_set_type::WORDS; i-- > 0;)
+      {
+        if (a.m_x.words()[i] != b.m_x.words()[i])
+        {
+          return a.m_x.words()[i] < b.m_x.words()[i];
+        }
+      }
+      return false;
+    };
+    auto res = std::pair<basic_state, symmetry>{ *this, symmetry::identity };
+    for (auto sym = std::size_t{ 1 }; sym < SYMMETRY_COUNT; ++sym)
+    {
+      const auto next = transformed(static_cast<symmetry>(sym));
+      if (less(next, res.first))
+      {
+        res = { next, static_cast<symmetry>(sym) };
+      }
+    }
+    return res;
+  }
+
+  template <std::size_t Columns, std::size_t Rows, std::size_t K>
+  cell_contents basic_state<Columns, Rows, K>::cell(const std::size_t column, const std::size_t row) const {
+    check_indices(column, row);
+    return unchecked_cell(column, row);
+  }
+
+  template <std::size_t Columns, std::size_t Rows, std::size_t K>
+  template <std::size_t Column, std::size_t Row>
+  cell_contents basic_state<Columns, Rows, K>::cell() const {
+    static_assert(Column < Columns, "The column index is out of bounds.");
+    static_assert(Row < Rows, "The row index is out of bounds.");
+    return unchecked_cell(Column, Row);
+  }
+
+  template <std::size_t Columns, std::size_t Rows, std::size_t K>
+  cell_contents basic_state<Columns, Rows, K>::unchecked_cell(const std::size_t column, const std::size_t row) const {
+    const auto index = row * Columns + column;
+    if (m_x.contains(index))
+    {
+      return cell_contents::x;
+    }
+    if (m_o.contains(index))
+    {
+      return cell_contents::o;
+    }
+    return cell_contents::empty;
+  }
+
+  template <std::size_t Columns, std::size_t Rows, std::size_t K>
+  void basic_state<Columns, Rows, K>::cell(const std::size_t column, const std::size_t row,
+                                           const cell_contents value) {
+    check_indices(column, row);
+    if (value != cell_contents::empty && value != cell_contents::x && value != cell_contents::o)
+    {
+      throw std::runtime_error{ "The cell value was invalid." };
+    }
+    const auto index = row * Columns + column;
+    const auto& keys = zobrist_keys()[index];
+    if (m_x.contains(index))
+    {
+      m_hash ^= keys[0];
+    }
+    else if (m_o.contains(index))
+    {
+      m_hash ^= keys[1];
+    }
+    m_x.erase(index);
+    m_o.erase(index);
+    if (value == cell_contents::x)
+    {
+      m_x.insert(index);
+      m_hash ^= keys[0];
+    }
+    else if (value == cell_contents::o)
+    {
+      m_o.insert(index);
+      m_hash ^= keys[1];
+    }
+  }
+
+}
+
+#endif
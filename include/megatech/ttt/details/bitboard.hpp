@@ -0,0 +1,297 @@
+/**
+ * @file bitboard.hpp
+ * @brief Bit-sliced game state object.
+ * @author Alexander Rothman <gnomesort@megate.ch>
+ * @date 2024
+ * @copyright AGPL-3.0+
+ */
+#ifndef MEGATECH_TTT_DETAILS_BITBOARD_HPP
+#define MEGATECH_TTT_DETAILS_BITBOARD_HPP
+
+#include <cstddef>
+#include <cinttypes>
+
+#include <bit>
+#include <stdexcept>
+
+#include "../enums.hpp"
+
+#include "cell_set.hpp"
+#include "planes.hpp"
+#include "state.hpp"
+
+namespace megatech::ttt::details {
+
+  /**
+   * @brief A game state stored as separate X and O occupancy planes.
+   * @details Where a state interleaves each cell as a 2-bit field, a bitboard keeps one 9-bit plane per player. Cells
+   *          use the same indices as cell_set. Line checks and move generation reduce to single mask operations on the
+   *          planes, which makes this layout better suited to search and analysis than the serialized form. The game
+   *          mode and phase are carried along unchanged so that conversion to and from a state is lossless.
+   */
+  class bitboard final {
+  private:
+    static constexpr std::uint32_t GAME_META_MASK{ 0xf0'00'00'00 };
+    static constexpr std::uint32_t GAME_MODE_MASK{ 0x80'00'00'00 };
+    static constexpr std::uint32_t GAME_PHASE_MASK{ 0x70'00'00'00 };
+    static constexpr std::uint32_t BOARD_LOW_BITS{ 0x00'01'55'55 };
+
+    std::uint32_t m_x{ };
+    std::uint32_t m_o{ };
+    std::uint32_t m_meta{ };
+  public:
+    /**
+     * @brief Create a bitboard for a new single player game.
+     */
+    constexpr bitboard() = default;
+
+    /**
+     * @brief Create a bitboard from a pair of occupancy planes.
+     * @details The resulting bitboard is in single player mode with the phase set to turn_x.
+     * @param x The cells marked with an X.
+     * @param o The cells marked with an O.
+     * @throw std::runtime_error If any cell is marked with both an X and an O.
+     */
+    constexpr bitboard(const cell_set x, const cell_set o);
+
+    /**
+     * @brief Create a bitboard from a state.
+     * @param st The state to convert.
+     */
+    explicit bitboard(const state& st);
+
+    /**
+     * @brief Copy a bitboard.
+     * @param other The bitboard to copy.
+     */
+    constexpr bitboard(const bitboard& other) = default;
+
+    /**
+     * @brief Move a bitboard.
+     * @param other The bitboard to move.
+     */
+    constexpr bitboard(bitboard&& other) = default;
+
+    /**
+     * @brief Destroy a bitboard.
+     */
+    constexpr ~bitboard() noexcept = default;
+
+    /**
+     * @brief Copy-assign a bitboard.
+     * @param rhs The bitboard to copy.
+     * @return A reference to the assigned bitboard.
+     */
+    constexpr bitboard& operator=(const bitboard& rhs) = default;
+
+    /**
+     * @brief Move-assign a bitboard.
+     * @param rhs The bitboard to move.
+     * @return A reference to the assigned bitboard.
+     */
+    constexpr bitboard& operator=(bitboard&& rhs) = default;
+
+    /**
+     * @brief Convert the bitboard into a state.
+     * @details The resulting state has the same board, mode, and phase. Converting a state to a bitboard and back
+     *          always produces an identical state.
+     */
+    explicit operator state() const;
+
+    /**
+     * @brief Compare two bitboards for equality.
+     * @param rhs The bitboard to compare to.
+     * @return True if the boards, modes, and phases are identical. False in all other cases.
+     */
+    constexpr bool operator==(const bitboard& rhs) const = default;
+
+    /**
+     * @brief Retrieve the current game mode.
+     * @return The game mode.
+     */
+    constexpr game_mode mode() const;
+
+    /**
+     * @brief Retrieve the current game phase.
+     * @return The game phase.
+     */
+    constexpr game_phase phase() const;
+
+    /**
+     * @brief Set the current game mode.
+     * @param value The new game mode.
+     * @throw std::runtime_error If the game mode is invalid.
+     */
+    constexpr void mode(const game_mode value);
+
+    /**
+     * @brief Set the current game phase.
+     * @param value The new game phase.
+     * @throw std::runtime_error If the game phase is invalid.
+     */
+    constexpr void phase(const game_phase value);
+
+    /**
+     * @brief Retrieve the cells marked with an X.
+     * @return The X occupancy plane.
+     */
+    constexpr cell_set x_cells() const;
+
+    /**
+     * @brief Retrieve the cells marked with an O.
+     * @return The O occupancy plane.
+     */
+    constexpr cell_set o_cells() const;
+
+    /**
+     * @brief Retrieve the cells that have not been marked.
+     * @return A set of the empty cells.
+     */
+    constexpr cell_set empty_cells() const;
+
+    /**
+     * @brief Retrieve the number of marked cells.
+     * @return The count of cells marked with either an X or an O.
+     */
+    constexpr std::size_t filled_cells() const;
+
+    /**
+     * @brief Query the content of a cell.
+     * @param index The index of the cell.
+     * @return The content of the cell. Indices greater than 8 are always empty.
+     */
+    constexpr cell_contents cell(const std::size_t index) const;
+
+    /**
+     * @brief Set the content of a cell.
+     * @param index The index of the cell. Indices greater than 8 are ignored.
+     * @param value The new content of the cell.
+     */
+    constexpr void cell(const std::size_t index, const cell_contents value);
+
+    /**
+     * @brief Determine which player should mark the next cell.
+     * @details This is derived from the board alone. X always moves first.
+     * @return cell_contents::o if X has marked more cells than O. Otherwise cell_contents::x.
+     */
+    constexpr cell_contents player_to_move() const;
+
+    /**
+     * @brief Determine which player, if any, has completed a row, column, or diagonal.
+     * @return The winning player or cell_contents::empty if neither player has completed a line.
+     */
+    constexpr cell_contents winner() const;
+
+    /**
+     * @brief Determine if every cell has been marked.
+     * @return True if the board is full. False in all other cases.
+     */
+    constexpr bool is_board_full() const;
+  };
+
+  constexpr bitboard::bitboard(const cell_set x, const cell_set o) :
+  m_x{ static_cast<std::uint32_t>(x) }, m_o{ static_cast<std::uint32_t>(o) } {
+    if (m_x & m_o)
+    {
+      throw std::runtime_error{ "A cell was marked by both players." };
+    }
+  }
+
+  inline bitboard::bitboard(const state& st) {
+    const auto data = static_cast<std::uint32_t>(st);
+    m_x = compress_plane(data & BOARD_LOW_BITS);
+    m_o = compress_plane((data >> 1) & BOARD_LOW_BITS);
+    m_meta = data & GAME_META_MASK;
+  }
+
+  inline bitboard::operator state() const {
+    return state{ m_meta | expand_plane(m_x) | (expand_plane(m_o) << 1) };
+  }
+
+  constexpr game_mode bitboard::mode() const {
+    return static_cast<game_mode>(m_meta & GAME_MODE_MASK);
+  }
+
+  constexpr game_phase bitboard::phase() const {
+    return static_cast<game_phase>(m_meta & GAME_PHASE_MASK);
+  }
+
+  constexpr void bitboard::mode(const game_mode value) {
+    const auto bits = static_cast<std::uint32_t>(value);
+    if (bits & ~GAME_MODE_MASK)
+    {
+      throw std::runtime_error{ "The game mode was invalid." };
+    }
+    m_meta = (m_meta & ~GAME_MODE_MASK) | bits;
+  }
+
+  constexpr void bitboard::phase(const game_phase value) {
+    const auto bits = static_cast<std::uint32_t>(value);
+    if (bits > static_cast<std::uint32_t>(game_phase::draw) || (bits & ~GAME_PHASE_MASK))
+    {
+      throw std::runtime_error{ "The game phase was invalid." };
+    }
+    m_meta = (m_meta & ~GAME_PHASE_MASK) | bits;
+  }
+
+  constexpr cell_set bitboard::x_cells() const {
+    return cell_set{ m_x };
+  }
+
+  constexpr cell_set bitboard::o_cells() const {
+    return cell_set{ m_o };
+  }
+
+  constexpr cell_set bitboard::empty_cells() const {
+    return cell_set{ ~(m_x | m_o) };
+  }
+
+  constexpr std::size_t bitboard::filled_cells() const {
+    return std::popcount(m_x | m_o);
+  }
+
+  constexpr cell_contents bitboard::cell(const std::size_t index) const {
+    if (x_cells().contains(index))
+    {
+      return cell_contents::x;
+    }
+    if (o_cells().contains(index))
+    {
+      return cell_contents::o;
+    }
+    return cell_contents::empty;
+  }
+
+  constexpr void bitboard::cell(const std::size_t index, const cell_contents value) {
+    if (index >= 9)
+    {
+      return;
+    }
+    const auto bit = std::uint32_t{ 1 } << index;
+    m_x = (m_x & ~bit) | (value == cell_contents::x ? bit : 0);
+    m_o = (m_o & ~bit) | (value == cell_contents::o ? bit : 0);
+  }
+
+  constexpr cell_contents bitboard::player_to_move() const {
+    return std::popcount(m_x) > std::popcount(m_o) ? cell_contents::o : cell_contents::x;
+  }
+
+  constexpr cell_contents bitboard::winner() const {
+    if (x_cells().contains_line())
+    {
+      return cell_contents::x;
+    }
+    if (o_cells().contains_line())
+    {
+      return cell_contents::o;
+    }
+    return cell_contents::empty;
+  }
+
+  constexpr bool bitboard::is_board_full() const {
+    return (m_x | m_o) == cell_set::ALL_CELLS;
+  }
+
+}
+
+#endif
@@ -0,0 +1,29 @@
+/**
+ * @file book.hpp
+ * @brief Precomputed optimal move table.
+ * @author Alexander Rothman <gnomesort@megate.ch>
+ * @date 2024
+ * @copyright AGPL-3.0+
+ */
+#ifndef MEGATECH_TTT_DETAILS_BOOK_HPP
+#define MEGATECH_TTT_DETAILS_BOOK_HPP
+
+#include "cell_set.hpp"
+#include "state.hpp"
+
+namespace megatech::ttt::details {
+
+  /**
+   * @brief Look up every optimal move for O in the given state.
+   * @details The underlying table is generated at compile time by solving every board. Scores follow the same rules as
+   *          details::solver so faster wins and slower losses are preferred. Querying the table performs no search.
+   *          Only the board is considered. The mode and phase of the state are ignored.
+   * @param st The state to look up.
+   * @return A cell_set containing each cell that O could mark to achieve the best possible outcome. If it is not O's
+   *         turn on the given board, or if the game has already ended, the returned set is empty.
+   */
+  cell_set book_moves(const state& st);
+
+}
+
+#endif
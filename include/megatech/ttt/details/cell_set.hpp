@@ -0,0 +1,263 @@
+/**
+ * @file cell_set.hpp
+ * @brief Game board cell set object.
+ * @author Alexander Rothman <gnomesort@megate.ch>
+ * @date 2024
+ * @copyright AGPL-3.0+
+ */
+#ifndef MEGATECH_TTT_DETAILS_CELL_SET_HPP
+#define MEGATECH_TTT_DETAILS_CELL_SET_HPP
+
+#include <cstddef>
+#include <cinttypes>
+
+#include <bit>
+#include <array>
+#include <iterator>
+
+namespace megatech::ttt::details {
+
+  /**
+   * @brief A set of game board cells stored as a 9-bit mask.
+   * @details Cells are identified by their index, which is (row * 3) + column. Bit i of the mask is set when cell i
+   *          is a member of the set. Iterating over a cell_set yields the index of each member in ascending order
+   *          without allocating any memory.
+   */
+  class cell_set final {
+  private:
+    std::uint32_t m_bits{ };
+  public:
+    /**
+     * @brief A forward iterator over the members of a cell_set.
+     */
+    class iterator final {
+    private:
+      std::uint32_t m_remaining{ };
+    public:
+      /**
+       * @brief The type of difference between iterators.
+       */
+      using difference_type = std::ptrdiff_t;
+
+      /**
+       * @brief The type of values produced by the iterator.
+       */
+      using value_type = std::size_t;
+
+      /**
+       * @brief Create a default initialized iterator.
+       * @details A default initialized iterator is equivalent to the end of any cell_set.
+       */
+      constexpr iterator() = default;
+
+      /**
+       * @brief Create an iterator over the members of a mask.
+       * @param remaining The mask of members that have not yet been visited.
+       */
+      constexpr explicit iterator(const std::uint32_t remaining);
+
+      /**
+       * @brief Retrieve the index of the current member.
+       * @return The index of the lowest unvisited member.
+       */
+      constexpr std::size_t operator*() const;
+
+      /**
+       * @brief Advance to the next member.
+       * @return A reference to the iterator.
+       */
+      constexpr iterator& operator++();
+
+      /**
+       * @brief Advance to the next member.
+       * @return A copy of the iterator before it was advanced.
+       */
+      constexpr iterator operator++(int);
+
+      /**
+       * @brief Compare two iterators for equality.
+       * @param rhs The iterator to compare to.
+       * @return True if both iterators have the same members left to visit. False in all other cases.
+       */
+      constexpr bool operator==(const iterator& rhs) const = default;
+    };
+
+    /**
+     * @brief A mask containing every cell on the game board.
+     */
+    static constexpr std::uint32_t ALL_CELLS{ 0x00'00'01'ff };
+
+    /**
+     * @brief Masks for every row, column, and diagonal of the game board.
+     * @details The rows come first (top to bottom), followed by the columns (left to right), the left-to-right
+     *          diagonal, and finally the right-to-left diagonal.
+     */
+    static constexpr std::array<std::uint32_t, 8> LINES{ 0x00'00'00'07, 0x00'00'00'38, 0x00'00'01'c0, 0x00'00'00'49,
+                                                         0x00'00'00'92, 0x00'00'01'24, 0x00'00'01'11,
+                                                         0x00'00'00'54 };
+
+    /**
+     * @brief Create an empty cell_set.
+     */
+    constexpr cell_set() = default;
+
+    /**
+     * @brief Create a cell_set from a mask.
+     * @param bits The mask of cells. Bits outside of ALL_CELLS are discarded.
+     */
+    constexpr explicit cell_set(const std::uint32_t bits);
+
+    /**
+     * @brief Convert the cell_set into its 9-bit mask.
+     */
+    constexpr explicit operator std::uint32_t() const;
+
+    /**
+     * @brief Determine if the set has no members.
+     * @return True if the set is empty. False in all other cases.
+     */
+    constexpr bool empty() const;
+
+    /**
+     * @brief Determine the number of members in the set.
+     * @return The count of cells in the set.
+     */
+    constexpr std::size_t size() const;
+
+    /**
+     * @brief Determine if a cell is a member of the set.
+     * @param index The index of the cell.
+     * @return True if the cell is a member of the set. False in all other cases.
+     */
+    constexpr bool contains(const std::size_t index) const;
+
+    /**
+     * @brief Determine if every cell of at least one row, column, or diagonal is a member of the set.
+     * @return True if the set contains a complete line. False in all other cases.
+     */
+    constexpr bool contains_line() const;
+
+    /**
+     * @brief Add a cell to the set.
+     * @param index The index of the cell. Indices greater than 8 are ignored.
+     */
+    constexpr void insert(const std::size_t index);
+
+    /**
+     * @brief Remove a cell from the set.
+     * @param index The index of the cell. Indices greater than 8 are ignored.
+     */
+    constexpr void erase(const std::size_t index);
+
+    /**
+     * @brief Compute the intersection of two sets.
+     * @param rhs The set to intersect with.
+     * @return A set of the cells that are members of both sets.
+     */
+    constexpr cell_set operator&(const cell_set rhs) const;
+
+    /**
+     * @brief Compute the union of two sets.
+     * @param rhs The set to combine with.
+     * @return A set of the cells that are members of either set.
+     */
+    constexpr cell_set operator|(const cell_set rhs) const;
+
+    /**
+     * @brief Compare two sets for equality.
+     * @param rhs The set to compare to.
+     * @return True if both sets have the same members. False in all other cases.
+     */
+    constexpr bool operator==(const cell_set& rhs) const = default;
+
+    /**
+     * @brief Retrieve an iterator to the first member of the set.
+     * @return An iterator to the lowest indexed member.
+     */
+    constexpr iterator begin() const;
+
+    /**
+     * @brief Retrieve an iterator past the last member of the set.
+     * @return An iterator that compares equal to an exhausted iterator.
+     */
+    constexpr iterator end() const;
+  };
+
+  constexpr cell_set::iterator::iterator(const std::uint32_t remaining) : m_remaining{ remaining } { }
+
+  constexpr std::size_t cell_set::iterator::operator*() const {
+    return std::countr_zero(m_remaining);
+  }
+
+  constexpr cell_set::iterator& cell_set::iterator::operator++() {
+    // Clear the lowest set bit.
+    m_remaining &= m_remaining - 1;
+    return *this;
+  }
+
+  constexpr cell_set::iterator cell_set::iterator::operator++(int) {
+    auto res = *this;
+    ++(*this);
+    return res;
+  }
+
+  constexpr cell_set::cell_set(const std::uint32_t bits) : m_bits{ bits & ALL_CELLS } { }
+
+  constexpr cell_set::operator std::uint32_t() const {
+    return m_bits;
+  }
+
+  constexpr bool cell_set::empty() const {
+    return m_bits == 0;
+  }
+
+  constexpr std::size_t cell_set::size() const {
+    return std::popcount(m_bits);
+  }
+
+  constexpr bool cell_set::contains(const std::size_t index) const {
+    return index < 9 && (m_bits & (1u << index));
+  }
+
+  constexpr bool cell_set::contains_line() const {
+    auto res = false;
+    for (const auto line : LINES)
+    {
+      res = res || (m_bits & line) == line;
+    }
+    return res;
+  }
+
+  constexpr void cell_set::insert(const std::size_t index) {
+    if (index < 9)
+    {
+      m_bits |= 1u << index;
+    }
+  }
+
+  constexpr void cell_set::erase(const std::size_t index) {
+    if (index < 9)
+    {
+      m_bits &= ~(1u << index);
+    }
+  }
+
+  constexpr cell_set cell_set::operator&(const cell_set rhs) const {
+    return cell_set{ m_bits & rhs.m_bits };
+  }
+
+  constexpr cell_set cell_set::operator|(const cell_set rhs) const {
+    return cell_set{ m_bits | rhs.m_bits };
+  }
+
+  constexpr cell_set::iterator cell_set::begin() const {
+    return iterator{ m_bits };
+  }
+
+  constexpr cell_set::iterator cell_set::end() const {
+    return iterator{ };
+  }
+
+}
+
+#endif
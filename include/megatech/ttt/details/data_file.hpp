@@ -37,6 +37,11 @@ namespace megatech::ttt::details {
    */
   constexpr unsigned char DATA_FILE_VERSION_1{ 1 };
 
+  /**
+   * @brief The version value for version 2 data file bodies.
+   */
+  constexpr unsigned char DATA_FILE_VERSION_2{ 2 };
+
   /**
    * @brief The generic header for all game data files.
    * @details This is a packed structure.
@@ -66,6 +71,17 @@ namespace megatech::ttt::details {
    */
   constexpr std::uint32_t DATA_FILE_REVERSE_ENDIANNESS{ 0xdd'cc'bb'aa };
 
+  /**
+   * @brief Reverse the order of the bytes in a 32-bit value.
+   * @details This converts values read from files written in the reverse byte order.
+   * @param value The value to convert.
+   * @return The value with its bytes in the opposite order.
+   */
+  constexpr std::uint32_t byte_swap(const std::uint32_t value) {
+    return ((value & 0x00'00'00'ff) << 24) | ((value & 0x00'00'ff'00) << 8) | ((value & 0x00'ff'00'00) >> 8) |
+           ((value & 0xff'00'00'00) >> 24);
+  }
+
   /**
    * @brief The body for version 1 game data files.
    * @details This is a packed structure.
@@ -82,6 +98,79 @@ namespace megatech::ttt::details {
     std::uint32_t state;
   };
 
+  /**
+   * @brief The offset, in bytes, of the version 2 body from the beginning of the file.
+   * @details The 3 bytes between the header and the body are padding and must be 0. The padding ensures that every
+   *          field of the body is aligned to 4 bytes within the file.
+   */
+  constexpr const std::size_t DATA_FILE_BODY_V2_OFFSET{ 12 };
+
+  /**
+   * @brief The fixed size part of the body for version 2 game data files.
+   * @details Version 2 files hold any number of games. This structure is followed immediately by a dense array of
+   *          data_file_record_v2 structures. The record for the game with ID n is always the nth record. All values
+   *          are stored in the byte order indicated by the endianness check value.
+   *
+   *          This is a packed structure.
+   */
+  struct data_file_body_v2 final {
+    /**
+     * @brief The endianness check value.
+     */
+    std::uint32_t endianness;
+
+    /**
+     * @brief The number of records that follow.
+     */
+    std::uint32_t count;
+  };
+
+  /**
+   * @brief A single game in a version 2 game data file.
+   * @details This is a packed structure.
+   */
+  struct data_file_record_v2 final {
+    /**
+     * @brief The game's ID. This must be equal to the index of the record.
+     */
+    std::uint32_t id;
+
+    /**
+     * @brief The current game state.
+     */
+    std::uint32_t state;
+  };
+
+  /**
+   * @brief The offset, in bytes, of the first version 2 record from the beginning of the file.
+   */
+  constexpr const std::size_t DATA_FILE_RECORDS_V2_OFFSET{ DATA_FILE_BODY_V2_OFFSET + sizeof(data_file_body_v2) };
+
+  /**
+   * @brief Compute the offset of a version 2 record from the beginning of the file.
+   * @param id The ID of the game.
+   * @return The offset, in bytes, of the record for the game.
+   */
+  constexpr std::size_t data_file_record_v2_offset(const std::uint32_t id) {
+    return DATA_FILE_RECORDS_V2_OFFSET + static_cast<std::size_t>(id) * sizeof(data_file_record_v2);
+  }
+
+  /**
+   * @brief Check the padding between the header and the body of a version 2 game data file.
+   * @param data The beginning of the file. At least DATA_FILE_BODY_V2_OFFSET bytes must be readable.
+   * @return True if every padding byte is 0. Otherwise false.
+   */
+  constexpr bool is_data_file_v2_padding_valid(const unsigned char *const data) {
+    for (auto i = sizeof(data_file_header); i < DATA_FILE_BODY_V2_OFFSET; ++i)
+    {
+      if (data[i])
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
 }
 
 #endif
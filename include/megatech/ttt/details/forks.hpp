@@ -0,0 +1,28 @@
+/**
+ * @file forks.hpp
+ * @brief Fork detection for the heuristic strategy.
+ * @author Alexander Rothman <gnomesort@megate.ch>
+ * @date 2024
+ * @copyright AGPL-3.0+
+ */
+#ifndef MEGATECH_TTT_DETAILS_FORKS_HPP
+#define MEGATECH_TTT_DETAILS_FORKS_HPP
+
+#include "cell_set.hpp"
+#include "state.hpp"
+
+namespace megatech::ttt::details {
+
+  /**
+   * @brief Find every cell that O can mark without allowing X to fork on the following turn.
+   * @details A fork is a position where X has more than one way to complete a line, so that O cannot block them all,
+   *          and O has no way to complete a line first. X is only considered to threaten a win once it has marked
+   *          more than two cells, and O once it has marked more than one.
+   * @param st The state to check. It is assumed that it is O's turn.
+   * @return A cell_set containing each empty cell that does not allow X to fork. This may be empty.
+   */
+  cell_set fork_blocks(const state& st);
+
+}
+
+#endif
@@ -0,0 +1,115 @@
+/**
+ * @file mapped_file.hpp
+ * @brief Memory mapped file access.
+ * @author Alexander Rothman <gnomesort@megate.ch>
+ * @date 2024
+ * @copyright AGPL-3.0+
+ */
+#ifndef MEGATECH_TTT_DETAILS_MAPPED_FILE_HPP
+#define MEGATECH_TTT_DETAILS_MAPPED_FILE_HPP
+
+#include <cstddef>
+
+#include <filesystem>
+
+namespace megatech::ttt::details {
+
+  /**
+   * @brief An object representing an entire file mapped into memory.
+   * @details Writable mappings are shared so that changes made through the mapping are changes to the file itself.
+   *          Read-only mappings are private to the process. Memory mapping is only available on POSIX systems.
+   */
+  class mapped_file final {
+  private:
+    unsigned char* m_data{ };
+    std::size_t m_size{ };
+    int m_descriptor{ -1 };
+  public:
+    /**
+     * @brief Whether files can be memory mapped on this system.
+     * @return True if mapped_file objects can be opened. False in any other case.
+     */
+    static bool is_available();
+
+    /**
+     * @brief Create a mapped_file that doesn't refer to any file.
+     */
+    mapped_file() = default;
+
+    /**
+     * @brief Map an existing file into memory.
+     * @param path The path to the file to map.
+     * @param writable Whether the mapping may be written.
+     * @throw std::runtime_error If memory mapping is unavailable or the file could not be opened or mapped. Empty
+     *                           files can't be mapped.
+     */
+    mapped_file(const std::filesystem::path& path, const bool writable);
+
+    /// @cond
+    mapped_file(const mapped_file& other) = delete;
+    /// @endcond
+
+    /**
+     * @brief Create a mapped_file by moving another.
+     * @param other The mapped_file to move. It is left without a file.
+     */
+    mapped_file(mapped_file&& other) noexcept;
+
+    /**
+     * @brief Destroy a mapped_file.
+     * @details If a file is mapped, it will be unmapped during destruction. Changes are not explicitly flushed.
+     */
+    ~mapped_file() noexcept;
+
+    /// @cond
+    mapped_file& operator=(const mapped_file& rhs) = delete;
+    /// @endcond
+
+    /**
+     * @brief Assign a mapped_file by moving another.
+     * @param rhs The mapped_file to move. It is left without a file.
+     * @return A reference to the assigned mapped_file.
+     */
+    mapped_file& operator=(mapped_file&& rhs) noexcept;
+
+    /**
+     * @brief Whether a file is mapped.
+     * @return True if the mapped_file refers to a file. False in any other case.
+     */
+    bool is_open() const;
+
+    /**
+     * @brief Retrieve the mapped bytes.
+     * @return A pointer to the first byte of the file or nullptr if no file is mapped.
+     */
+    unsigned char* data();
+
+    /**
+     * @brief Retrieve the mapped bytes.
+     * @return A pointer to the first byte of the file or nullptr if no file is mapped.
+     */
+    const unsigned char* data() const;
+
+    /**
+     * @brief Retrieve the size of the mapping.
+     * @return The size of the file, in bytes, when it was mapped.
+     */
+    std::size_t size() const;
+
+    /**
+     * @brief Synchronously write changes made through the mapping to storage.
+     * @param metadata Whether the file's metadata should be flushed in addition to its contents.
+     * @throw std::runtime_error If no file is mapped or flushing failed.
+     */
+    void flush(const bool metadata);
+
+    /**
+     * @brief Unmap the file.
+     * @details Nothing happens if no file is mapped.
+     */
+    void close() noexcept;
+  };
+
+}
+
+#endif
@@ -0,0 +1,48 @@
+/**
+ * @file planes.hpp
+ * @brief Conversion between interleaved game boards and occupancy planes.
+ * @author Alexander Rothman <gnomesort@megate.ch>
+ * @date 2024
+ * @copyright AGPL-3.0+
+ */
+#ifndef MEGATECH_TTT_DETAILS_PLANES_HPP
+#define MEGATECH_TTT_DETAILS_PLANES_HPP
+
+#include <cinttypes>
+
+namespace megatech::ttt::details {
+
+  /**
+   * @brief Gather every other bit of a value, starting with bit 0, into a contiguous plane.
+   * @details Applied to a serialized game board, this converts the low bit of each 2-bit cell into a 9-bit plane with
+   *          exactly one bit per cell.
+   * @param bits The interleaved bits to compress. Odd bits are ignored.
+   * @return The compressed plane.
+   */
+  constexpr std::uint32_t compress_plane(std::uint32_t bits) {
+    bits &= 0x55'55'55'55;
+    bits = (bits | (bits >> 1)) & 0x33'33'33'33;
+    bits = (bits | (bits >> 2)) & 0x0f'0f'0f'0f;
+    bits = (bits | (bits >> 4)) & 0x00'ff'00'ff;
+    bits = (bits | (bits >> 8)) & 0x00'00'ff'ff;
+    return bits;
+  }
+
+  /**
+   * @brief Spread the low 16 bits of a plane into every other bit of a value, starting with bit 0.
+   * @details This is the inverse of compress_plane().
+   * @param bits The plane to expand. Bits above bit 15 are ignored.
+   * @return The interleaved bits.
+   */
+  constexpr std::uint32_t expand_plane(std::uint32_t bits) {
+    bits &= 0x00'00'ff'ff;
+    bits = (bits | (bits << 8)) & 0x00'ff'00'ff;
+    bits = (bits | (bits << 4)) & 0x0f'0f'0f'0f;
+    bits = (bits | (bits << 2)) & 0x33'33'33'33;
+    bits = (bits | (bits << 1)) & 0x55'55'55'55;
+    return bits;
+  }
+
+}
+
+#endif
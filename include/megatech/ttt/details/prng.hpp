@@ -0,0 +1,116 @@
+/**
+ * @file prng.hpp
+ * @brief Reproducible pseudo-random number generator.
+ * @author Alexander Rothman <gnomesort@megate.ch>
+ * @date 2024
+ * @copyright AGPL-3.0+
+ */
+#ifndef MEGATECH_TTT_DETAILS_PRNG_HPP
+#define MEGATECH_TTT_DETAILS_PRNG_HPP
+
+#include <cstddef>
+#include <cinttypes>
+
+#include <array>
+#include <bit>
+#include <limits>
+
+namespace megatech::ttt::details {
+
+  /**
+   * @brief A small, fast pseudo-random number generator with a fully specified output sequence.
+   * @details This is xoshiro256** (Blackman and Vigna, 2018). The 256-bit state is expanded from a 64-bit seed with
+   *          splitmix64, as the authors recommend. Unlike the engines and distributions in <random>, every output of
+   *          this generator, including the output of below(), is the same on every platform and toolchain. The
+   *          generator satisfies the UniformRandomBitGenerator requirements.
+   */
+  class prng final {
+  private:
+    std::array<std::uint64_t, 4> m_state{ };
+  public:
+    /**
+     * @brief The type of values produced by the generator.
+     */
+    using result_type = std::uint64_t;
+
+    /**
+     * @brief Retrieve the smallest value the generator can produce.
+     * @return 0.
+     */
+    static constexpr result_type min();
+
+    /**
+     * @brief Retrieve the largest value the generator can produce.
+     * @return 2^64 - 1.
+     */
+    static constexpr result_type max();
+
+    /**
+     * @brief Create a generator from a seed.
+     * @param seed The seed. Every seed, including 0, produces a valid generator.
+     */
+    constexpr explicit prng(const std::uint64_t seed);
+
+    /**
+     * @brief Produce the next value in the sequence.
+     * @return A uniformly distributed 64-bit value.
+     */
+    constexpr result_type operator()();
+
+    /**
+     * @brief Produce a uniformly distributed value less than a bound.
+     * @details Values are drawn by masking generator output to the smallest covering power of two and rejecting any
+     *          result that is not less than bound. The result is unbiased and fully determined by the seed.
+     * @param bound The exclusive upper bound. A bound of 0 always produces 0.
+     * @return A value in the range [0, bound).
+     */
+    constexpr result_type below(const result_type bound);
+  };
+
+  constexpr prng::result_type prng::min() {
+    return std::numeric_limits<result_type>::min();
+  }
+
+  constexpr prng::result_type prng::max() {
+    return std::numeric_limits<result_type>::max();
+  }
+
+  constexpr prng::prng(std::uint64_t seed) {
+    for (auto& word : m_state)
+    {
+      auto z = (seed += 0x9e'37'79'b9'7f'4a'7c'15);
+      z = (z ^ (z >> 30)) * 0xbf'58'47'6d'1c'e4'e5'b9;
+      z = (z ^ (z >> 27)) * 0x94'd0'49'bb'13'31'11'eb;
+      word = z ^ (z >> 31);
+    }
+  }
+
+  constexpr prng::result_type prng::operator()() {
+    const auto res = std::rotl(m_state[1] * 5, 7) * 9;
+    const auto t = m_state[1] << 17;
+    m_state[2] ^= m_state[0];
+    m_state[3] ^= m_state[1];
+    m_state[1] ^= m_state[2];
+    m_state[0] ^= m_state[3];
+    m_state[2] ^= t;
+    m_state[3] = std::rotl(m_state[3], 45);
+    return res;
+  }
+
+  constexpr prng::result_type prng::below(const result_type bound) {
+    if (bound < 2)
+    {
+      return 0;
+    }
+    const auto mask = max() >> std::countl_zero(bound - 1);
+    auto res = (*this)() & mask;
+    while (res >= bound)
+    {
+      res = (*this)() & mask;
+    }
+    return res;
+  }
+
+}
+
+#endif
@@ -0,0 +1,100 @@
+/**
+ * @file rank.hpp
+ * @brief Dense indexing of game states.
+ * @author Alexander Rothman <gnomesort@megate.ch>
+ * @date 2024
+ * @copyright AGPL-3.0+
+ */
+#ifndef MEGATECH_TTT_DETAILS_RANK_HPP
+#define MEGATECH_TTT_DETAILS_RANK_HPP
+
+#include <cstddef>
+#include <cinttypes>
+
+#include <array>
+
+#include "bitboard.hpp"
+#include "state.hpp"
+
+namespace megatech::ttt::details {
+
+  /**
+   * @brief The number of distinct game boards, including boards that cannot occur in a game.
+   */
+  constexpr std::size_t BOARD_COUNT{ 19'683 };
+
+  /**
+   * @brief The number of distinct game boards that can occur in a game.
+   * @details This counts the empty board, every board in play, and every board where the game has just ended.
+   */
+  constexpr std::size_t REACHABLE_BOARD_COUNT{ 5'478 };
+
+  /**
+   * @brief A table converting a 9-bit plane into the base 3 number with a 1 digit wherever the plane has a 1 bit.
+   */
+  inline constexpr std::array<std::uint16_t, 512> TERNARY_DIGITS = []() {
+    auto res = std::array<std::uint16_t, 512>{ };
+    for (auto plane = std::size_t{ 0 }; plane < res.size(); ++plane)
+    {
+      for (auto i = std::size_t{ 0 }, digit = std::size_t{ 1 }; i < 9; ++i, digit *= 3)
+      {
+        if (plane & (std::size_t{ 1 } << i))
+        {
+          res[plane] += digit;
+        }
+      }
+    }
+    return res;
+  }();
+
+  /**
+   * @brief Compute the base 3 index of a game board.
+   * @details Digit i of the index holds the content of cell i (0 for empty, 1 for X, and 2 for O). Every board maps
+   *          to a unique value less than BOARD_COUNT.
+   * @param x_plane A 9-bit mask of the cells marked with an X.
+   * @param o_plane A 9-bit mask of the cells marked with an O. No cell may be marked in both planes.
+   * @return The base 3 index of the board.
+   */
+  constexpr std::size_t board_index(const std::uint32_t x_plane, const std::uint32_t o_plane) {
+    return TERNARY_DIGITS[x_plane & 0x1'ff] + 2 * TERNARY_DIGITS[o_plane & 0x1'ff];
+  }
+
+  /**
+   * @brief Compute the base 3 index of a bitboard's game board.
+   * @param board The bitboard to index. The mode and phase are ignored.
+   * @return The base 3 index of the board.
+   */
+  constexpr std::size_t board_index(const bitboard& board) {
+    return board_index(static_cast<std::uint32_t>(board.x_cells()), static_cast<std::uint32_t>(board.o_cells()));
+  }
+
+  /**
+   * @brief Compute the base 3 index of a state's game board.
+   * @param st The state to index. The mode and phase are ignored.
+   * @return The base 3 index of the state's board.
+   */
+  std::size_t board_index(const state& st);
+
+  /**
+   * @brief Compute the dense rank of a state's game board.
+   * @details Every board that can occur in a game is assigned a unique rank less than REACHABLE_BOARD_COUNT. Ranks
+   *          are assigned in ascending order of board_index. This allows per-position data to be stored in flat
+   *          arrays.
+   * @param st The state to rank. The mode and phase are ignored.
+   * @return The rank of the state's board.
+   * @throw std::runtime_error If the board cannot occur in a game.
+   */
+  std::size_t rank(const state& st);
+
+  /**
+   * @brief Reconstruct a state from the rank of its game board.
+   * @details The returned state is a single player game. Its phase is derived from the board.
+   * @param index A rank previously produced by rank().
+   * @return A state with the board corresponding to the rank.
+   * @throw std::runtime_error If the rank is not less than REACHABLE_BOARD_COUNT.
+   */
+  state unrank(const std::size_t index);
+
+}
+
+#endif
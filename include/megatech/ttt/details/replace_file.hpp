@@ -0,0 +1,33 @@
+/**
+ * @file replace_file.hpp
+ * @brief Atomic file replacement.
+ * @author Alexander Rothman <gnomesort@megate.ch>
+ * @date 2024
+ * @copyright AGPL-3.0+
+ */
+#ifndef MEGATECH_TTT_DETAILS_REPLACE_FILE_HPP
+#define MEGATECH_TTT_DETAILS_REPLACE_FILE_HPP
+
+#include <filesystem>
+#include <vector>
+
+#include "../game.hpp"
+
+namespace megatech::ttt::details {
+
+  /**
+   * @brief Replace the contents of a file without ever leaving it partially written.
+   * @details The new contents are written to a temporary file beside the old one (".~new" followed by the file name)
+   *          which is then renamed over it. Readers see either the old file or the new file. Callers must hold the
+   *          file's lockfile so that the temporary name can't collide.
+   * @param path The absolute path to the file to replace. It doesn't need to exist.
+   * @param contents The new contents of the file.
+   * @param policy How thoroughly the new file is flushed to storage before and after it replaces the old one.
+   * @throw std::runtime_error If the temporary file could not be written or the replacement could not be flushed.
+   */
+  void replace_file(const std::filesystem::path& path, const std::vector<unsigned char>& contents,
+                    const sync_policy policy);
+
+}
+
+#endif
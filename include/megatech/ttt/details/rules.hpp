@@ -0,0 +1,31 @@
+/**
+ * @file rules.hpp
+ * @brief The rules of Tic-Tac-Toe.
+ * @author Alexander Rothman <gnomesort@megate.ch>
+ * @date 2024
+ * @copyright AGPL-3.0+
+ */
+#ifndef MEGATECH_TTT_DETAILS_RULES_HPP
+#define MEGATECH_TTT_DETAILS_RULES_HPP
+
+#include <cstddef>
+
+#include "state.hpp"
+
+namespace megatech::ttt::details {
+
+  /**
+   * @brief Take a turn by marking a cell with the current player's mark.
+   * @details If the game is still in play, the indicated cell is marked for the current player. Then the state's
+   *          phase is updated based on the usual rules of Tic-Tac-Toe. If the game has already ended, nothing happens.
+   * @param st The state to update.
+   * @param column The column index of the cell to mark.
+   * @param row The row index of the cell to mark.
+   * @return True if a cell was marked. False if the game had already ended.
+   * @throw std::runtime_error If the indicated cell is already marked.
+   */
+  bool take_turn(state& st, const std::size_t column, const std::size_t row);
+
+}
+
+#endif
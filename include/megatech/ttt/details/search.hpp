@@ -0,0 +1,332 @@
+/**
+ * @file search.hpp
+ * @brief Time and node bounded game tree search.
+ * @author Alexander Rothman <gnomesort@megate.ch>
+ * @date 2024
+ * @copyright AGPL-3.0+
+ */
+#ifndef MEGATECH_TTT_DETAILS_SEARCH_HPP
+#define MEGATECH_TTT_DETAILS_SEARCH_HPP
+
+#include <cstddef>
+#include <cstdlib>
+#include <cinttypes>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+#include "../enums.hpp"
+
+namespace megatech::ttt::details {
+
+  /**
+   * @brief The outcome of a bounded search.
+   */
+  struct search_result final {
+    /**
+     * @brief The index, (row * COLUMNS) + column, of the best cell found.
+     */
+    std::size_t move;
+
+    /**
+     * @brief The score of the best move from the perspective of the player to move.
+     */
+    int score;
+
+    /**
+     * @brief The deepest iteration, in plies, that was searched to completion.
+     */
+    std::size_t depth;
+
+    /**
+     * @brief The number of game tree nodes visited.
+     */
+    std::size_t nodes;
+
+    /**
+     * @brief Whether the score is exact.
+     * @details This is true when the search reached the end of every line of play or proved a forced win or loss.
+     */
+    bool complete;
+  };
+
+  /**
+   * @brief An iterative deepening negamax search with a deadline and a node limit.
+   * @details Each iteration searches one ply deeper than the last with alpha-beta pruning. Before every iteration the
+   *          root moves are sorted by their scores from the previous iteration so that the best move so far is
+   *          searched first. Inside the tree, cells that lie on more lines are tried first. Positions at the search
+   *          horizon are scored by counting the lines that are still open to each player. When the budget runs out
+   *          mid-iteration the best move found so far is returned.
+   *
+   *          Scores are from the perspective of the player to move. A draw is worth 0. A win is worth WIN_SCORE - n
+   *          where n is the number of marks on the board before the winning move is made. Horizon scores are always
+   *          much smaller than any win.
+   *
+   *          The search never allocates memory. Every buffer is sized by the board at compile time.
+   * @tparam State The game state type to search. This is state or any basic_state.
+   */
+  template <typename State>
+  class iterative_search final {
+  public:
+    /**
+     * @brief The clock used to enforce deadlines.
+     */
+    using clock = std::chrono::steady_clock;
+
+    /**
+     * @brief The score of a win made on an empty board. Every other win scores less.
+     */
+    static constexpr int WIN_SCORE{ 1'000'000 };
+
+    /**
+     * @brief A node limit that never stops the search.
+     */
+    static constexpr std::size_t UNLIMITED_NODES{ std::numeric_limits<std::size_t>::max() };
+  private:
+    static constexpr std::size_t CELLS{ State::CELLS };
+    static constexpr int INFINITE_SCORE{ 2 * WIN_SCORE };
+    // Reading the clock is much more expensive than visiting a node so the deadline is only checked periodically.
+    static constexpr std::size_t DEADLINE_CHECK_INTERVAL{ 1'024 };
+
+    std::array<std::size_t, CELLS> m_cell_order{ };
+    std::array<std::size_t, CELLS> m_root_moves{ };
+    std::array<int, CELLS> m_root_scores{ };
+    std::size_t m_root_count{ };
+    clock::time_point m_deadline{ };
+    std::size_t m_node_limit{ };
+    std::size_t m_nodes{ };
+    std::size_t m_next_deadline_check{ };
+    bool m_stopped{ };
+
+    static cell_contents opponent(const cell_contents player);
+    static int evaluate(const State& st, const cell_contents player);
+    bool should_stop();
+    int negamax(State& st, const cell_contents player, const std::size_t depth, int alpha, int beta);
+  public:
+    /**
+     * @brief Create a search object.
+     */
+    iterative_search();
+
+    /**
+     * @brief Find the best move for the player to move within a budget.
+     * @details The first iteration (1 ply) always runs to completion so that a legal move is returned even when the
+     *          budget is already spent. Searching stops early if the result is exact.
+     * @param st The state to search. The game must still be in play.
+     * @param budget The maximum amount of time to spend searching.
+     * @param node_limit The maximum number of nodes to visit.
+     * @return The best move found along with its score and search statistics.
+     * @throw std::runtime_error If the game represented by the state has already ended.
+     */
+    search_result run(const State& st, const clock::duration budget, const std::size_t node_limit = UNLIMITED_NODES);
+  };
+
+  template <typename State>
+  cell_contents iterative_search<State>::opponent(const cell_contents player) {
+    return player == cell_contents::x ? cell_contents::o : cell_contents::x;
+  }
+
+  template <typename State>
+  int iterative_search<State>::evaluate(const State& st, const cell_contents player) {
+    const auto own = player == cell_contents::x ? st.x_cells() : st.o_cells();
+    const auto theirs = player == cell_contents::x ? st.o_cells() : st.x_cells();
+    auto res = 0;
+    // A line is only worth anything to a player if the opponent has no marks in it. More marks are worth more.
+    for (const auto& line : State::lines())
+    {
+      const auto mine = static_cast<int>((own & line).size());
+      const auto other = static_cast<int>((theirs & line).size());
+      if (!other)
+      {
+        res += mine * mine;
+      }
+      else if (!mine)
+      {
+        res -= other * other;
+      }
+    }
+    return res;
+  }
+
+  template <typename State>
+  bool iterative_search<State>::should_stop() {
+    if (m_stopped || m_nodes >= m_node_limit)
+    {
+      m_stopped = true;
+    }
+    else if (m_nodes >= m_next_deadline_check)
+    {
+      m_next_deadline_check = m_nodes + DEADLINE_CHECK_INTERVAL;
+      m_stopped = clock::now() >= m_deadline;
+    }
+    return m_stopped;
+  }
+
+  template <typename State>
+  int iterative_search<State>::negamax(State& st, const cell_contents player, const std::size_t depth, int alpha,
+                                       int beta) {
+    ++m_nodes;
+    if (!depth)
+    {
+      return evaluate(st, player);
+    }
+    if (should_stop())
+    {
+      return 0;
+    }
+    const auto filled = st.filled_cells();
+    const auto empty = st.empty_cells();
+    auto best = -INFINITE_SCORE;
+    for (const auto cell : m_cell_order)
+    {
+      if (!empty.contains(cell))
+      {
+        continue;
+      }
+      const auto column = cell % State::COLUMNS;
+      const auto row = cell / State::COLUMNS;
+      auto score = 0;
+      if (st.completes_line(column, row, player))
+      {
+        score = WIN_SCORE - static_cast<int>(filled);
+      }
+      else if (filled + 1 < CELLS)
+      {
+        st.cell(column, row, player);
+        score = -negamax(st, opponent(player), depth - 1, -beta, -alpha);
+        st.cell(column, row, cell_contents::empty);
+        if (m_stopped)
+        {
+          return 0;
+        }
+      }
+      best = std::max(best, score);
+      alpha = std::max(alpha, score);
+      if (alpha >= beta)
+      {
+        break;
+      }
+    }
+    return best;
+  }
+
+  template <typename State>
+  iterative_search<State>::iterative_search() {
+    // Cells on more lines create more threats. On the standard board this is the center, then corners, then edges.
+    auto line_counts = std::array<std::size_t, CELLS>{ };
+    for (const auto& line : State::lines())
+    {
+      for (const auto cell : line)
+      {
+        ++line_counts[cell];
+      }
+    }
+    // This is an insertion sort so that ties keep ascending index order without allocating a merge buffer.
+    for (auto i = std::size_t{ 0 }; i < CELLS; ++i)
+    {
+      m_cell_order[i] = i;
+      for (auto j = i; j > 0 && line_counts[m_cell_order[j]] > line_counts[m_cell_order[j - 1]]; --j)
+      {
+        std::swap(m_cell_order[j], m_cell_order[j - 1]);
+      }
+    }
+  }
+
+  template <typename State>
+  search_result iterative_search<State>::run(const State& st, const clock::duration budget,
+                                             const std::size_t node_limit) {
+    if (st.winner() != cell_contents::empty || st.is_board_full())
+    {
+      throw std::runtime_error{ "The game has already ended." };
+    }
+    m_deadline = clock::now() + budget;
+    m_node_limit = node_limit;
+    // The root is the first node visited.
+    m_nodes = 1;
+    m_next_deadline_check = 0;
+    m_stopped = false;
+    const auto player = st.count_x() > st.count_o() ? cell_contents::o : cell_contents::x;
+    const auto filled = st.filled_cells();
+    const auto empty = st.empty_cells();
+    m_root_count = 0;
+    for (const auto cell : m_cell_order)
+    {
+      if (empty.contains(cell))
+      {
+        m_root_moves[m_root_count++] = cell;
+      }
+    }
+    auto res = search_result{ m_root_moves[0], 0, 0, 0, false };
+    auto cpy = st;
+    for (auto depth = std::size_t{ 1 }; depth <= m_root_count; ++depth)
+    {
+      auto best = -INFINITE_SCORE;
+      auto best_move = m_root_moves[0];
+      auto searched = std::size_t{ 0 };
+      for (; searched < m_root_count; ++searched)
+      {
+        const auto cell = m_root_moves[searched];
+        const auto column = cell % State::COLUMNS;
+        const auto row = cell / State::COLUMNS;
+        auto score = 0;
+        if (cpy.completes_line(column, row, player))
+        {
+          score = WIN_SCORE - static_cast<int>(filled);
+        }
+        else if (filled + 1 < CELLS)
+        {
+          cpy.cell(column, row, player);
+          // Only moves that beat the current best matter at the root so the window is narrowed to (best, infinity).
+          score = -negamax(cpy, opponent(player), depth - 1, -INFINITE_SCORE, -best);
+          cpy.cell(column, row, cell_contents::empty);
+          if (m_stopped)
+          {
+            break;
+          }
+        }
+        m_root_scores[searched] = score;
+        if (score > best)
+        {
+          best = score;
+          best_move = cell;
+        }
+      }
+      if (m_stopped)
+      {
+        // The previous best move is always searched first. Any completed move that beat it is at least as good.
+        if (searched)
+        {
+          res.move = best_move;
+          res.score = best;
+        }
+        break;
+      }
+      // Order the root moves for the next iteration. Ties keep their previous order.
+      for (auto i = std::size_t{ 1 }; i < m_root_count; ++i)
+      {
+        for (auto j = i; j > 0 && m_root_scores[j] > m_root_scores[j - 1]; --j)
+        {
+          std::swap(m_root_scores[j], m_root_scores[j - 1]);
+          std::swap(m_root_moves[j], m_root_moves[j - 1]);
+        }
+      }
+      res = { best_move, best, depth, 0, false };
+      // Every line of play ends within the horizon once the depth covers every empty cell. A win or a loss within the
+      // horizon is forced and can't change with more depth.
+      if (depth == m_root_count || std::abs(best) > WIN_SCORE - static_cast<int>(CELLS) - 1)
+      {
+        res.complete = true;
+        break;
+      }
+    }
+    res.nodes = m_nodes;
+    return res;
+  }
+
+}
+
+#endif
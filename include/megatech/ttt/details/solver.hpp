@@ -0,0 +1,132 @@
+/**
+ * @file solver.hpp
+ * @brief Perfect play game tree solver.
+ * @author Alexander Rothman <gnomesort@megate.ch>
+ * @date 2024
+ * @copyright AGPL-3.0+
+ */
+#ifndef MEGATECH_TTT_DETAILS_SOLVER_HPP
+#define MEGATECH_TTT_DETAILS_SOLVER_HPP
+
+#include <cstddef>
+#include <cinttypes>
+
+#include <vector>
+
+#include "../enums.hpp"
+
+#include "state.hpp"
+
+namespace megatech::ttt::details {
+
+  /**
+   * @brief An object that finds game theoretically optimal moves.
+   * @details The solver performs a negamax search with alpha-beta pruning over the game tree rooted at a given state.
+   *          The player to move is inferred from the board (X always moves first). Results are cached in a fixed size
+   *          open-addressing transposition table indexed by the Zobrist hash of the board so repeated queries are
+   *          cheap. The table is allocated once when the solver is created.
+   *
+   *          Scores are always from the perspective of the player to move. A draw is worth 0. A win is worth
+   *          10 - n where n is the number of marks on the board before the winning move is made. This makes faster
+   *          wins (and slower losses) preferable.
+   */
+  class solver final {
+  private:
+    enum class bound : std::uint8_t {
+      exact,
+      lower,
+      upper
+    };
+
+    struct entry final {
+      std::uint32_t board;
+      std::int8_t score;
+      bound type;
+    };
+
+    // The table size must be a power of two. There are only 5,478 reachable boards so every board fits.
+    static constexpr std::size_t TABLE_SIZE{ 8'192 };
+    static constexpr std::size_t MAX_PROBES{ 8 };
+    static constexpr std::uint32_t EMPTY_SLOT{ 0xff'ff'ff'ff };
+
+    std::vector<entry> m_table{ };
+    std::size_t m_nodes{ };
+
+    const entry* probe(const state& st) const;
+    void store(const state& st, const int score, const bound type);
+    int negamax(state& st, const cell_contents player, int alpha, int beta);
+  public:
+    /**
+     * @brief A score greater than any possible game outcome.
+     */
+    static constexpr int INFINITE_SCORE{ 100 };
+
+    /**
+     * @brief Create a solver with an empty transposition table.
+     */
+    solver();
+
+    /**
+     * @brief Create a solver as a copy of another.
+     * @param other The solver to copy.
+     */
+    solver(const solver& other) = default;
+
+    /**
+     * @brief Create a solver by moving another.
+     * @param other The solver to move.
+     */
+    solver(solver&& other) = default;
+
+    /**
+     * @brief Destroy a solver.
+     */
+    ~solver() noexcept = default;
+
+    /**
+     * @brief Assign a solver as a copy of another.
+     * @param rhs The solver to copy.
+     * @return A reference to the assigned object.
+     */
+    solver& operator=(const solver& rhs) = default;
+
+    /**
+     * @brief Assign a solver by moving another.
+     * @param rhs The solver to move.
+     * @return A reference to the assigned object.
+     */
+    solver& operator=(solver&& rhs) = default;
+
+    /**
+     * @brief Determine the game theoretic value of a state.
+     * @param st The state to evaluate. The game must still be in play.
+     * @return The score of the state from the perspective of the player to move.
+     * @throw std::runtime_error If the game represented by the state has already ended.
+     */
+    int evaluate(const state& st);
+
+    /**
+     * @brief Find an optimal move for the player to move.
+     * @details Moves are considered in the order center, corners, edges. The first move with the best score is
+     *          selected.
+     * @param st The state to find a move in. The game must still be in play.
+     * @return The index, (row * 3) + column, of an optimal cell to mark.
+     * @throw std::runtime_error If the game represented by the state has already ended.
+     */
+    std::size_t best_move(const state& st);
+
+    /**
+     * @brief Retrieve the number of game tree nodes visited by the solver.
+     * @return The count of nodes searched since the solver was created or last cleared.
+     */
+    std::size_t nodes() const;
+
+    /**
+     * @brief Empty the transposition table and reset the node count.
+     */
+    void clear();
+  };
+
+}
+
+#endif
@@ -11,15 +11,46 @@
 #include <cstddef>
 #include <cinttypes>
 
+#include <array>
+#include <utility>
+
 #include "../enums.hpp"
 
+#include "basic_state.hpp"
+#include "cell_set.hpp"
+
 namespace megatech::ttt::details {
 
-  class state final {
+  /**
+   * @brief Determine where a symmetry moves a cell.
+   * @param sym The symmetry to apply.
+   * @param index The index, (row * 3) + column, of the cell to move.
+   * @return The index of the cell after the symmetry is applied.
+   * @throw std::runtime_error If the symmetry is ill formed or the cell index is out of range.
+   */
+  std::size_t transform_cell(const symmetry sym, const std::size_t index);
+
+  template <>
+  class basic_state<3, 3, 3>;
+
+  /**
+   * @brief The game state of the standard 3x3 game.
+   */
+  using state = basic_state<3, 3, 3>;
+
+  /**
+   * @brief The game state of the standard 3x3 game.
+   * @details Unlike the general template, this specialization stores the entire state in a single packed 32-bit
+   *          value. This is the value written to the data file. Each cell occupies 2 bits, so board masks and
+   *          per-row lookup tables are used in place of the generated line masks.
+   *
+   *          A cached Zobrist hash of the board is kept beside the packed value, so a state object is 8 bytes. Only
+   *          the 4 byte packed value is written to the data file.
+   */
+  template <>
+  class basic_state<3, 3, 3> final {
   private:
     static constexpr std::uint32_t   GAME_MODE_MASK{ 0x80'00'00'00 };
-    static constexpr std::uint32_t  GAME_PHASE_MASK{ 0x70'00'00'00 };
-    static constexpr std::uint32_t GAME_UNUSED_MASK{ 0x0f'fc'00'00 };
     static constexpr std::uint32_t  GAME_BOARD_MASK{ 0x00'03'ff'ff };
 
     static constexpr std::uint32_t  BOARD_UPPER_ROW_MASK{ 0x00'00'00'3f };
@@ -43,43 +74,102 @@ namespace megatech::ttt::details {
     static constexpr std::uint32_t     BOARD_CELL_X{ 0x01 };
     static constexpr std::uint32_t     BOARD_CELL_O{ 0x02 };
 
-    static constexpr std::uint32_t COUNT_X_MASK{ 0x00'01'55'55 };
     static constexpr std::uint32_t COUNT_O_MASK{ 0x00'02'aa'aa };
 
     std::uint32_t m_data{ };
+    std::uint32_t m_hash{ };
+
+    void rehash();
   public:
+    /**
+     * @brief The number of columns on the game board.
+     */
+    static constexpr std::size_t COLUMNS{ 3 };
+
+    /**
+     * @brief The number of rows on the game board.
+     */
+    static constexpr std::size_t ROWS{ 3 };
+
+    /**
+     * @brief The number of cells on the game board.
+     */
+    static constexpr std::size_t CELLS{ 9 };
+
+    /**
+     * @brief The number of consecutive marks required to win.
+     */
+    static constexpr std::size_t LINE_LENGTH{ 3 };
+
+    /**
+     * @brief The type used to represent sets of cells.
+     */
+    using cell_set_type = cell_set;
+
+    /**
+     * @brief The number of rows, columns, and diagonals on the game board.
+     */
+    static constexpr std::size_t LINE_COUNT{ 8 };
+
+    /**
+     * @brief Retrieve every row, column, and diagonal on the game board.
+     * @details The lines are in the same order as cell_set::LINES.
+     * @return A reference to the line masks.
+     */
+    static const std::array<cell_set, LINE_COUNT>& lines();
+
     /**
      * @brief A constant representing all possible game board cell bits.
      */
     static constexpr std::uint32_t ALL_CELL_BITS{ 0x03 };
 
+    /**
+     * @brief A mask of the bits of a serialized state that hold the game phase.
+     */
+    static constexpr std::uint32_t GAME_PHASE_MASK{ 0x70'00'00'00 };
+
+    /**
+     * @brief The smallest value of the game phase bits that does not correspond to a game phase.
+     */
+    static constexpr std::uint32_t FIRST_INVALID_PHASE{ 0x50'00'00'00 };
+
+    /**
+     * @brief A mask of the bits of a serialized state that are unused and must be 0.
+     */
+    static constexpr std::uint32_t GAME_UNUSED_MASK{ 0x0f'fc'00'00 };
+
+    /**
+     * @brief A mask of the low bit of every cell of a serialized state. This is the bit that is set for X.
+     */
+    static constexpr std::uint32_t COUNT_X_MASK{ 0x00'01'55'55 };
+
     /**
      * @brief Create a default initialized state.
      */
-    state() = default;
+    basic_state() = default;
 
     /**
      * @brief Create a state with the specified data.
      * @throw std::runtime_error If the data does not represent a valid game state.
      */
-    explicit state(const std::uint32_t data);
+    explicit basic_state(const std::uint32_t data);
 
     /**
      * @brief Create a state as a copy of another.
      * @param other The state to copy.
      */
-    state(const state& other) = default;
+    basic_state(const state& other) = default;
 
     /**
      * @brief Create a state by moving another.
      * @param other The state to move.
      */
-    state(state&& other) = default;
+    basic_state(state&& other) = default;
 
     /**
      * @brief Destroy a state.
      */
-    ~state() noexcept = default;
+    ~basic_state() noexcept = default;
 
     /**
      * @brief Convert the state into a 32-bit unsigned integer.
@@ -126,6 +216,17 @@ namespace megatech::ttt::details {
      */
     void phase(const game_phase gp);
 
+    /**
+     * @brief Retrieve the Zobrist hash of the current game board.
+     * @details Each mark on the board contributes a fixed pseudorandom key to the hash. The hash is maintained
+     *          incrementally as cells are marked and is passed through a short mixing function when it is retrieved.
+     *          Unlike the raw state value, every bit of the hash depends on the board. This makes it suitable for
+     *          indexing open-addressing hash tables. The mode and phase do not contribute to the hash. The hash of the
+     *          empty board is 0.
+     * @return A 32-bit hash of the current game board.
+     */
+    std::uint32_t hash() const;
+
     /**
      * @brief Retrieve the current game board.
      * @return A 32-bit unsigned integer value representing the current game board.
@@ -200,6 +301,30 @@ namespace megatech::ttt::details {
      */
     bool is_right_diagonal_o() const;
 
+    /**
+     * @brief Determine which player, if any, has marked an entire row, column, or diagonal.
+     * @details Rather than checking each line in turn, each player's marks are gathered into a 9-bit plane and used to
+     *          index a precomputed table of winning planes.
+     * @return cell_contents::x if X has marked an entire line. cell_contents::o if O has marked an entire line.
+     *         cell_contents::empty in all other cases.
+     */
+    cell_contents winner() const;
+
+    /**
+     * @brief Determine if marking the given cell would complete a row, column, or diagonal.
+     * @details Only the lines passing through the given cell are checked. This makes it suitable for determining
+     *          whether a turn was (or would be) a winning turn without rescanning the entire board. The cell may
+     *          already contain the given value, in which case this determines whether the existing mark is part of a
+     *          complete line. The state itself is not modified.
+     * @param column The column index of the cell.
+     * @param row The row index of the cell.
+     * @param value The value to consider the cell marked with.
+     * @return True if every cell of at least one line through (column, row) would be marked with value. False in all
+     *         other cases, including when value is cell_contents::empty.
+     * @throw std::runtime_error If the column or row index is out of range.
+     */
+    bool completes_line(const std::size_t column, const std::size_t row, const cell_contents value) const;
+
     /**
      * @brief Determine if the given cell is unmarked.
      * @param column The column index of the cell.
@@ -236,6 +361,44 @@ namespace megatech::ttt::details {
      */
     std::size_t count_o() const;
 
+    /**
+     * @brief Retrieve the set of unmarked cells.
+     * @details This is the set of legal moves in any state that is still in play.
+     * @return A cell_set containing every unmarked cell.
+     */
+    cell_set empty_cells() const;
+
+    /**
+     * @brief Retrieve the set of cells marked with an X.
+     * @return A cell_set containing every cell marked with an X.
+     */
+    cell_set x_cells() const;
+
+    /**
+     * @brief Retrieve the set of cells marked with an O.
+     * @return A cell_set containing every cell marked with an O.
+     */
+    cell_set o_cells() const;
+
+    /**
+     * @brief Apply a symmetry to the game board.
+     * @details The mode and phase of the state are preserved.
+     * @param sym The symmetry to apply.
+     * @return A new state where every mark has been moved according to sym.
+     * @throw std::runtime_error If the symmetry is ill formed.
+     */
+    state transformed(const symmetry sym) const;
+
+    /**
+     * @brief Find the canonical representative of the state among its symmetries.
+     * @details Every state that can be reached from another by a rotation or reflection has the same canonical
+     *          state. The canonical state is the transformed state with the least board value. The mode and phase of
+     *          the state are preserved. A cell index in the canonical state can be mapped back to this state with
+     *          transform_cell(inverse(sym), index).
+     * @return A pair containing the canonical state and the symmetry that transforms this state into it.
+     */
+    std::pair<state, symmetry> canonical() const;
+
     /**
      * @brief Query the content of the cell at the given position.
      * @param column The column index of the cell.
@@ -245,6 +408,25 @@ namespace megatech::ttt::details {
      */
     cell_contents cell(const std::size_t column, const std::size_t row) const;
 
+    /**
+     * @brief Query the content of the cell at a position known at compile time.
+     * @tparam Column The column index of the cell.
+     * @tparam Row The row index of the cell.
+     * @return The content of the desired cell.
+     */
+    template <std::size_t Column, std::size_t Row>
+    cell_contents cell() const;
+
+    /**
+     * @brief Query the content of the cell at the given position without checking the indices.
+     * @details This is intended for internal use with indices that are already known to be valid. Use cell() for any
+     *          external input.
+     * @param column The column index of the cell. This must be less than 3.
+     * @param row The row index of the cell. This must be less than 3.
+     * @return The content of the desired cell.
+     */
+    cell_contents unchecked_cell(const std::size_t column, const std::size_t row) const;
+
     /**
      * @brief Set the content of the cell at the given position.
      * @param column The column index of the cell.
@@ -256,6 +438,21 @@ namespace megatech::ttt::details {
 
   };
 
+  static_assert(sizeof(state) == 8);
+
+  template <std::size_t Column, std::size_t Row>
+  cell_contents basic_state<3, 3, 3>::cell() const {
+    static_assert(Column < 3, "The column index is out of bounds.");
+    static_assert(Row < 3, "The row index is out of bounds.");
+    constexpr auto shift = Row * BOARD_MIDDLE_ROW_SHIFT + Column * BOARD_CENTER_CELL_SHIFT;
+    return static_cast<cell_contents>((m_data >> shift) & ALL_CELL_BITS);
+  }
+
+  inline cell_contents state::unchecked_cell(const std::size_t column, const std::size_t row) const {
+    const auto shift = row * BOARD_MIDDLE_ROW_SHIFT + column * BOARD_CENTER_CELL_SHIFT;
+    return static_cast<cell_contents>((m_data >> shift) & ALL_CELL_BITS);
+  }
+
 }
 
 #endif
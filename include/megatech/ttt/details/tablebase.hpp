@@ -0,0 +1,242 @@
+/**
+ * @file tablebase.hpp
+ * @brief Precomputed game theoretic values for every reachable position.
+ * @author Alexander Rothman <gnomesort@megate.ch>
+ * @date 2024
+ * @copyright AGPL-3.0+
+ */
+#ifndef MEGATECH_TTT_DETAILS_TABLEBASE_HPP
+#define MEGATECH_TTT_DETAILS_TABLEBASE_HPP
+
+#include <cstddef>
+#include <cinttypes>
+
+#include <filesystem>
+#include <limits>
+#include <vector>
+
+#include "mapped_file.hpp"
+#include "state.hpp"
+
+namespace megatech::ttt::details {
+
+  constexpr const std::size_t TABLEBASE_HEADER_MAGIC_LENGTH{ 8 };
+
+  /**
+   * @brief The magic string used to verify the identity of tablebase files.
+   * @details This follows the same pattern as DATA_FILE_HEADER_MAGIC but with the application identifier "ttb". The
+   *          two kinds of file can never be mistaken for each other.
+   */
+  constexpr unsigned char TABLEBASE_HEADER_MAGIC[TABLEBASE_HEADER_MAGIC_LENGTH]{ 0x89, 0x74, 0x74, 0x62, 0x0d, 0x0a,
+                                                                                 0x1a, 0x0a };
+
+  /**
+   * @brief The version value for version 1 tablebase files.
+   */
+  constexpr unsigned char TABLEBASE_VERSION_1{ 1 };
+
+  /**
+   * @brief The ways that tablebase entries can be encoded.
+   */
+  enum class tablebase_encoding : std::uint8_t {
+    /**
+     * @brief Each position uses 4 bits that record both its value and its distance.
+     * @details Losses always occur an even number of plies away and wins an odd number, so a board with n cells needs
+     *          n + 2 codes. This encoding is only available for boards with at most 14 cells.
+     */
+    distance = 0,
+
+    /**
+     * @brief Each position uses 2 bits that record its value alone.
+     * @details The distance of a win or loss is not stored. This encoding is available for any board.
+     */
+    value = 1
+  };
+
+  /**
+   * @brief The header for all tablebase files.
+   * @details The header is immediately followed by the table. Each position uses either 4 or 2 bits depending on the
+   *          encoding. Positions are packed in rank order starting from the least significant bits of each byte. The
+   *          header records the board dimensions so that tables for larger boards can share the format.
+   */
+  struct tablebase_header final {
+    /**
+     * @brief The magic header string.
+     */
+    unsigned char magic[TABLEBASE_HEADER_MAGIC_LENGTH];
+
+    /**
+     * @brief The version of the file.
+     */
+    unsigned char version;
+
+    /**
+     * @brief The number of columns on the game board.
+     */
+    unsigned char columns;
+
+    /**
+     * @brief The number of rows on the game board.
+     */
+    unsigned char rows;
+
+    /**
+     * @brief The number of marks in a row needed to win.
+     */
+    unsigned char line_length;
+
+    /**
+     * @brief The encoding of each entry. This is one of the tablebase_encoding values.
+     */
+    unsigned char encoding;
+
+    /**
+     * @brief Reserved bytes. These must be 0.
+     */
+    unsigned char reserved[3];
+
+    /**
+     * @brief The endianness check value. This uses the same values as game data files.
+     */
+    std::uint32_t endianness;
+
+    /**
+     * @brief The number of positions in the table.
+     */
+    std::uint32_t positions;
+  };
+
+  /**
+   * @brief Game theoretic outcomes from the perspective of the player to move.
+   */
+  enum class game_value : std::uint8_t {
+    /**
+     * @brief Neither player can force a win.
+     */
+    draw = 0,
+
+    /**
+     * @brief The opponent can force a win, or already has won.
+     */
+    loss = 1,
+
+    /**
+     * @brief The player to move can force a win.
+     */
+    win = 2
+  };
+
+  /**
+   * @brief The result of a tablebase probe.
+   */
+  struct tablebase_entry final {
+    /**
+     * @brief The outcome of the position under optimal play.
+     */
+    game_value value;
+
+    /**
+     * @brief The number of plies until the game ends under optimal play.
+     * @details The winning player finishes as quickly as possible and the losing player delays as long as possible.
+     *          A position in which the game has already ended has a distance of 0. Tables using
+     *          tablebase_encoding::value do not record the distance of wins and losses, so these are reported as
+     *          TABLEBASE_UNKNOWN_DISTANCE.
+     */
+    std::size_t distance;
+  };
+
+  /**
+   * @brief The distance reported for wins and losses by tables that do not record distances.
+   */
+  constexpr const std::size_t TABLEBASE_UNKNOWN_DISTANCE{ std::numeric_limits<std::size_t>::max() };
+
+  /**
+   * @brief Compute the tablebase for every reachable position by retrograde analysis.
+   * @details Analysis starts from every finished game and works backwards by removing the most recent mark. A
+   *          position is won as soon as any successor is lost for the opponent and lost once every successor is won
+   *          for the opponent. Positions that are never resolved are draws. Each position is visited a constant number
+   *          of times so the work is linear in the number of positions.
+   * @param encoding The encoding of each entry in the table.
+   * @return The packed table, without a header, indexed by rank().
+   * @throw std::runtime_error If the encoding is invalid.
+   */
+  std::vector<unsigned char> generate_tablebase(const tablebase_encoding encoding = tablebase_encoding::distance);
+
+  /**
+   * @brief Write a tablebase file.
+   * @details The file is written with replace_file() while its lockfile is held, so an existing tablebase is never
+   *          left partially written.
+   * @param path The path to write to. Any existing file is replaced.
+   * @param encoding The encoding of each entry in the table.
+   * @throw std::runtime_error If the encoding is invalid, the file is locked, or the file could not be written.
+   */
+  void write_tablebase(const std::filesystem::path& path,
+                       const tablebase_encoding encoding = tablebase_encoding::distance);
+
+  /**
+   * @brief A read-only view of a tablebase file.
+   * @details On POSIX systems the file is mapped into memory and pages are loaded on demand. On other systems the
+   *          table is read into memory when the tablebase is opened. In either case a probe is a single memory access.
+   */
+  class tablebase final {
+  private:
+    const unsigned char* m_table{ };
+    mapped_file m_file{ };
+    std::vector<unsigned char> m_buffer{ };
+    tablebase_encoding m_encoding{ tablebase_encoding::distance };
+
+    void close() noexcept;
+  public:
+    /**
+     * @brief Open a tablebase file.
+     * @param path The path to the tablebase file.
+     * @throw std::runtime_error If the file could not be opened, is corrupt, or was generated for a different board.
+     */
+    explicit tablebase(const std::filesystem::path& path);
+
+    /**
+     * @brief Retrieve the encoding of the table's entries.
+     * @return The encoding used by the tablebase file.
+     */
+    tablebase_encoding encoding() const;
+
+    /// @cond
+    tablebase(const tablebase& other) = delete;
+    /// @endcond
+
+    /**
+     * @brief Create a tablebase by moving another.
+     * @param other The tablebase to move. It is left without a table.
+     */
+    tablebase(tablebase&& other) noexcept;
+
+    /**
+     * @brief Destroy a tablebase.
+     * @details If the file is mapped, it will be unmapped during destruction.
+     */
+    ~tablebase() noexcept;
+
+    /// @cond
+    tablebase& operator=(const tablebase& rhs) = delete;
+    /// @endcond
+
+    /**
+     * @brief Assign a tablebase by moving another.
+     * @param rhs The tablebase to move. It is left without a table.
+     * @return A reference to the assigned tablebase.
+     */
+    tablebase& operator=(tablebase&& rhs) noexcept;
+
+    /**
+     * @brief Look up the game theoretic value of a state.
+     * @param st The state to look up. The mode and phase are ignored.
+     * @return The outcome and distance of the state's board from the perspective of the player to move. If the table
+     *         does not record distances, the distance of a win or loss is TABLEBASE_UNKNOWN_DISTANCE.
+     * @throw std::runtime_error If the board cannot occur in a game or the tablebase has been moved from.
+     */
+    tablebase_entry probe(const state& st) const;
+  };
+
+}
+
+#endif
@@ -0,0 +1,40 @@
+/**
+ * @file validation.hpp
+ * @brief Bulk validation of serialized game states.
+ * @author Alexander Rothman <gnomesort@megate.ch>
+ * @date 2024
+ * @copyright AGPL-3.0+
+ */
+#ifndef MEGATECH_TTT_DETAILS_VALIDATION_HPP
+#define MEGATECH_TTT_DETAILS_VALIDATION_HPP
+
+#include <cstddef>
+#include <cinttypes>
+
+#include <span>
+
+namespace megatech::ttt::details {
+
+  /**
+   * @brief Check whether a serialized game state would be accepted by the details::state constructor.
+   * @param data The serialized state to check.
+   * @return True if the state is valid. Otherwise false.
+   */
+  bool is_valid_state(const std::uint32_t data) noexcept;
+
+  /**
+   * @brief Check a sequence of serialized game states for validity.
+   * @details Each state is checked with the same rules as the details::state constructor, but invalid states are
+   *          reported instead of throwing. On x86 targets, the states are checked 8 at a time using AVX2 when the
+   *          running CPU supports it and SSE2 otherwise.
+   * @param states The serialized states to check.
+   * @param results An output span. Each element is set to true if the corresponding state is valid and false
+   *                otherwise. This must be the same size as states.
+   * @return The number of invalid states found.
+   * @throw std::runtime_error If states and results are not the same size.
+   */
+  std::size_t validate_states(const std::span<const std::uint32_t> states, const std::span<bool> results);
+
+}
+
+#endif
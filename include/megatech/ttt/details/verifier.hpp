@@ -0,0 +1,75 @@
+/**
+ * @file verifier.hpp
+ * @brief Exhaustive verification of CPU player strategies.
+ * @author Alexander Rothman <gnomesort@megate.ch>
+ * @date 2024
+ * @copyright AGPL-3.0+
+ */
+#ifndef MEGATECH_TTT_DETAILS_VERIFIER_HPP
+#define MEGATECH_TTT_DETAILS_VERIFIER_HPP
+
+#include <cstddef>
+#include <cinttypes>
+
+#include <optional>
+
+#include "../strategy.hpp"
+
+#include "state.hpp"
+
+namespace megatech::ttt::details {
+
+  /**
+   * @brief The outcome of an exhaustive strategy verification.
+   */
+  struct verification_result final {
+    /**
+     * @brief The number of positions visited, including the empty board.
+     */
+    std::uint64_t nodes{ };
+
+    /**
+     * @brief The number of finished games reached.
+     */
+    std::uint64_t games{ };
+
+    /**
+     * @brief The number of finished games won by X.
+     */
+    std::uint64_t x_wins{ };
+
+    /**
+     * @brief The number of finished games won by O.
+     */
+    std::uint64_t o_wins{ };
+
+    /**
+     * @brief The number of finished games that ended in a draw.
+     */
+    std::uint64_t draws{ };
+
+    /**
+     * @brief One of the final positions in which X won, if there were any.
+     */
+    std::optional<state> loss{ };
+  };
+
+  /**
+   * @brief Enumerate every game in which X plays any legal move and O plays any move a strategy could choose.
+   * @details The game tree is split into subtrees that are distributed over a work-stealing thread pool. Wherever a
+   *          strategy would break a tie at random, every tied move is followed. The tree, and therefore every count
+   *          in the result, is the same for any seed and any number of threads. A result with no X wins proves that
+   *          O never loses.
+   * @param algorithm The algorithm used by O.
+   * @param seed The base seed for each worker's strategy. Worker i uses seed plus i.
+   * @param threads The number of worker threads to use.
+   * @return The counts of positions and game outcomes found.
+   * @throw std::runtime_error If threads is 0, if the algorithm is invalid, or if the strategy fails to select an
+   *                           empty cell.
+   */
+  verification_result verify_strategy(const strategy_algorithm algorithm, const std::uint64_t seed,
+                                      const std::size_t threads);
+
+}
+
+#endif
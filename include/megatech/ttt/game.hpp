@@ -17,7 +17,9 @@
 
 #include "enums.hpp"
 
+#include "details/data_file.hpp"
 #include "details/lockfile.hpp"
+#include "details/mapped_file.hpp"
 #include "details/state.hpp"
 
 namespace megatech::ttt {
@@ -27,31 +29,94 @@ namespace megatech::ttt {
    */
   const std::filesystem::path DEFAULT_GAME_NAME{ ".ttt" };
 
+  /**
+   * @brief Ways in which a game data file can be opened.
+   */
+  enum class open_mode {
+    /**
+     * @brief The file is locked while the game is open and the state is written back when the game is destroyed.
+     */
+    read_write,
+
+    /**
+     * @brief The file is read once and never written.
+     * @details Read-only games don't take the lock so any number of them can be open alongside each other and
+     *          alongside a writer.
+     */
+    read_only
+  };
+
+  /**
+   * @brief How thoroughly a game data file is flushed to storage when it is written.
+   * @details Policies other than none are only honored on POSIX systems.
+   */
+  enum class sync_policy {
+    /**
+     * @brief The data is handed to the operating system and never explicitly flushed.
+     */
+    none,
+
+    /**
+     * @brief The file contents are flushed to storage before the file replaces the previous one.
+     */
+    data,
+
+    /**
+     * @brief The file contents and metadata are flushed before the file replaces the previous one and the directory
+     *        is flushed afterward so that the replacement itself survives a crash.
+     */
+    full
+  };
+
   /**
    * @brief An object representing the state of a game of Tic-Tac-Toe.
    * @details The game object is responsible for enforcing the rules of Tic-Tac-Toe. It is also responsible for
    *          persisting that state between executions. When a game is created the corresponding file is read. When
-   *          a game is destroyed the state is written back to the same file.
+   *          a game is destroyed the state is written back to the same file if it changed, unless the game is
+   *          read-only.
    */
   class game final {
   private:
     details::state m_state{ };
     std::filesystem::path m_path{ };
     details::lockfile m_lock{ DEFAULT_GAME_NAME };
+    details::mapped_file m_file{ };
+    std::uint32_t m_id{ };
+    open_mode m_open_mode{ open_mode::read_write };
+    sync_policy m_sync_policy{ sync_policy::none };
+    std::size_t m_record_offset{ sizeof(details::data_file_header) };
+    unsigned char m_version{ details::DATA_FILE_VERSION_1 };
+    bool m_reversed{ };
+    bool m_dirty{ };
 
+    void check_data_file() const;
+    std::uint32_t normalize(const std::uint32_t value) const;
+    std::size_t locate_record(const unsigned char* data, const std::size_t size, const std::uintmax_t file_size);
+    void load_record(const unsigned char* record);
     void read_data_file();
-    cell_contents find_winner() const;
-    void update_play_state();
-    void take_turn(const std::size_t column, const std::size_t row, const cell_contents value);
+    void update_data_file();
+    void write_data_file() const;
   public:
     /**
      * @brief Create a game using the existing state in the given file.
+     * @details If the file holds more than one game, the game with ID 0 is used.
      * @param path A path to a valid game data file.
      * @throw std::runtime_error If the input path is not valid, the file indicated by the path cannot be locked,
      *                           or the file data is corrupt.
      */
     explicit game(const std::filesystem::path& path);
 
+    /**
+     * @brief Create a game using the existing state in the given file with the given access.
+     * @details A game opened with open_mode::read_only can be inspected but never modified and it never writes to
+     *          its file. Read-only games do not lock the file.
+     * @param path A path to a valid game data file.
+     * @param access Whether the game may be modified and written back.
+     * @throw std::runtime_error If the input path is not valid, the access is open_mode::read_write and the file
+     *                           indicated by the path cannot be locked, or the file data is corrupt.
+     */
+    game(const std::filesystem::path& path, const open_mode access);
+
     /**
      * @brief Create a game with a new state in the given file.
      * @details Unlike the other constructor this constructor always initializes the game's state. If the game file
@@ -63,6 +128,33 @@ namespace megatech::ttt {
      */
     game(const std::filesystem::path& path, const game_mode mode);
 
+    /**
+     * @brief Create a game using the existing state of one of the games in the given file.
+     * @details Only the requested game's record is read regardless of how many games the file holds. Files that
+     *          hold a single game only have a game with ID 0. A read-write game locks the whole file, not just its
+     *          own record, so only one read-write game object can be open per file at a time. Use game_table to
+     *          share the games of a file between several players.
+     * @param path A path to a valid game data file.
+     * @param id The ID of the game to open.
+     * @param access Whether the game may be modified and written back.
+     * @throw std::runtime_error If the input path is not valid, the access is open_mode::read_write and the file
+     *                           indicated by the path cannot be locked, the file data is corrupt, or the file has no
+     *                           game with the given ID.
+     */
+    game(const std::filesystem::path& path, const std::uint32_t id, const open_mode access);
+
+    /**
+     * @brief Create a game with a new state in place of one of the games in the given file.
+     * @details The other games in the file are not changed. If the file doesn't exist, a file holding a single game
+     *          is created. In that case the ID must be 0.
+     * @param path A path to a valid game data file.
+     * @param id The ID of the game to replace.
+     * @param mode The mode (e.g., single player or multiplayer) of the newly created game.
+     * @throw std::runtime_error If the input path is not valid, the file indicated by the path cannot be locked,
+     *                           the file data is corrupt, or the file has no game with the given ID.
+     */
+    game(const std::filesystem::path& path, const std::uint32_t id, const game_mode mode);
+
     /// @cond
     game(const game& other) = delete;
     game(game&& other) = default;
@@ -70,7 +162,11 @@ namespace megatech::ttt {
 
     /**
      * @brief Destroy a game object.
-     * @details During destruction the state of the game is always written back to storage.
+     * @details During destruction the state of the game is written back to storage if it changed and the game was
+     *          not opened with open_mode::read_only. When the file is a memory mapped version 2 file already in the
+     *          system byte order, only the stored state is updated in place. Otherwise the new data is written to a
+     *          temporary file that then replaces the old file. Either way the data file is never left partially
+     *          written.
      */
     ~game() noexcept;
 
@@ -86,6 +182,24 @@ namespace megatech::ttt {
      */
     const details::state& state() const;
 
+    /**
+     * @brief Retrieve the game's ID within its data file.
+     * @return The game's ID. This is always 0 for files that hold a single game.
+     */
+    std::uint32_t id() const;
+
+    /**
+     * @brief Retrieve the policy used to flush the game data file when it is written.
+     * @return The game's sync_policy. This is sync_policy::none unless it was changed.
+     */
+    sync_policy synchronization() const;
+
+    /**
+     * @brief Set the policy used to flush the game data file when it is written.
+     * @param policy The new sync_policy.
+     */
+    void synchronization(const sync_policy policy);
+
     /**
      * @brief Take a turn by marking a cell with the current player's mark.
      * @details This is the main interface through which a game is played. If the indicated cell is unmarked, the game
@@ -93,11 +207,26 @@ namespace megatech::ttt {
      *          rules of Tic-Tac-Toe.
      * @param column The column index of the cell to mark.
      * @param row The row index of the cell to mark.
-     * @throw std::runtime_error If the indicated cell is already marked.
+     * @throw std::runtime_error If the indicated cell is already marked or the game was opened with
+     *                           open_mode::read_only.
      */
     void take_turn(const std::size_t column, const std::size_t row);
   };
 
+  /**
+   * @brief Create a game data file holding many games.
+   * @details Every game in the file is new and has the same mode. Game IDs are dense so the games have IDs 0 through
+   *          count - 1. Any existing file is replaced. Individual games can be opened by passing their IDs to the
+   *          game constructors.
+   * @param path A path to the game data file to create.
+   * @param count The number of games in the file.
+   * @param mode The mode (e.g., single player or multiplayer) of every game.
+   * @param policy How thoroughly the new file is flushed to storage.
+   * @throw std::runtime_error If the file indicated by the path cannot be locked or written.
+   */
+  void create_game_table(const std::filesystem::path& path, const std::uint32_t count, const game_mode mode,
+                         const sync_policy policy = sync_policy::none);
+
   /**
    * @brief Write a game object to an output stream.
    * @details This is a utility function for displaying a game's state. It will output the following:
@@ -113,11 +242,14 @@ namespace megatech::ttt {
   std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits>& os, const game& g) {
     const auto& st = g.state();
     os << "    0  1  2 " << std::endl
-       << "  0  " << to_string(st.cell(0, 0)) << "|" << to_string(st.cell(1, 0)) << "|" << to_string(st.cell(2, 0))
+       << "  0  " << to_string(st.cell<0, 0>()) << "|" << to_string(st.cell<1, 0>()) << "|"
+       << to_string(st.cell<2, 0>())
        << "  " << std::endl << "    ------- " << std::endl
-       << "  1  " << to_string(st.cell(0, 1)) << "|" << to_string(st.cell(1, 1)) << "|" << to_string(st.cell(2, 1))
+       << "  1  " << to_string(st.cell<0, 1>()) << "|" << to_string(st.cell<1, 1>()) << "|"
+       << to_string(st.cell<2, 1>())
        << "  " << std::endl << "    ------- " << std::endl
-       << "  2  " << to_string(st.cell(0, 2)) << "|" << to_string(st.cell(1, 2)) << "|" << to_string(st.cell(2, 2))
+       << "  2  " << to_string(st.cell<0, 2>()) << "|" << to_string(st.cell<1, 2>()) << "|"
+       << to_string(st.cell<2, 2>())
        << "  "<< std::endl;
     switch (st.mode())
     {
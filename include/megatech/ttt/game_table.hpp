@@ -0,0 +1,111 @@
+/**
+ * @file game_table.hpp
+ * @brief Lock-free shared access to many games of Tic-Tac-Toe.
+ * @author Alexander Rothman <gnomesort@megate.ch>
+ * @date 2024
+ * @copyright AGPL-3.0+
+ */
+#ifndef MEGATECH_TTT_GAME_TABLE_HPP
+#define MEGATECH_TTT_GAME_TABLE_HPP
+
+#include <cstddef>
+#include <cinttypes>
+
+#include <filesystem>
+
+#include "enums.hpp"
+#include "game.hpp"
+
+#include "details/mapped_file.hpp"
+#include "details/state.hpp"
+
+namespace megatech::ttt {
+
+  /**
+   * @brief An object providing concurrent access to every game in a game data file that holds many games.
+   * @details The file is memory mapped and shared with every other process that maps it. Each game's state is a
+   *          single aligned 32-bit word in the file. Turns are taken by reading the state, applying the turn to a
+   *          copy, and atomically replacing the state only if no other turn was taken in the meantime. If another
+   *          turn was taken, the turn is retried against the new state. No lock is ever taken so any number of
+   *          threads and processes can play the games in a table at once.
+   *
+   *          Games in a file that is open as a game_table must not be changed through game objects at the same time.
+   *          Replacing the file (e.g., with create_game_table()) detaches tables that are already open from it.
+   *
+   *          Game tables are only available on POSIX systems.
+   */
+  class game_table final {
+  private:
+    details::mapped_file m_file{ };
+    std::uint32_t m_size{ };
+
+    std::uint32_t& slot(const std::uint32_t id) const;
+  public:
+    /**
+     * @brief Open a game data file that holds many games.
+     * @details If the file was written in the reverse byte order, it is rewritten in the system byte order first.
+     *          That requires taking the file's lock once.
+     * @param path A path to a valid version 2 game data file.
+     * @throw std::runtime_error If game tables are unavailable, the input path is not valid, the file could not be
+     *                           mapped or rewritten, or the file data is corrupt or doesn't hold many games.
+     */
+    explicit game_table(const std::filesystem::path& path);
+
+    /// @cond
+    game_table(const game_table& other) = delete;
+    game_table(game_table&& other) = default;
+    ~game_table() noexcept = default;
+    game_table& operator=(const game_table& rhs) = delete;
+    game_table& operator=(game_table&& rhs) = default;
+    /// @endcond
+
+    /**
+     * @brief Retrieve the number of games in the table.
+     * @return The number of games. Game IDs range from 0 to one less than this.
+     */
+    std::uint32_t size() const;
+
+    /**
+     * @brief Retrieve the current state of a game.
+     * @param id The ID of the game.
+     * @return A copy of the game's state.
+     * @throw std::runtime_error If the ID is not in the table or the game's record is corrupt.
+     */
+    details::state state(const std::uint32_t id) const;
+
+    /**
+     * @brief Take a turn in a game by marking a cell with the given player's mark.
+     * @details This behaves like game::take_turn(), except that the caller names the player it is moving for. Other
+     *          processes may take turns in the same game at any time, so the turn is only taken if it is still that
+     *          player's turn when the cell is marked. A turn is never applied for the other player.
+     * @param id The ID of the game.
+     * @param player The player taking the turn. This must be cell_contents::x or cell_contents::o.
+     * @param column The column index of the cell to mark.
+     * @param row The row index of the cell to mark.
+     * @return True if the cell was marked. False if the game had already ended or it is not the player's turn.
+     * @throw std::runtime_error If the ID is not in the table, the player is invalid, the game's record is corrupt, or
+     *                           the indicated cell is already marked.
+     */
+    bool take_turn(const std::uint32_t id, const cell_contents player, const std::size_t column, const std::size_t row);
+
+    /**
+     * @brief Replace a game with a new game.
+     * @param id The ID of the game.
+     * @param mode The mode (e.g., single player or multiplayer) of the new game.
+     * @throw std::runtime_error If the ID is not in the table or the game's record is corrupt.
+     */
+    void reset(const std::uint32_t id, const game_mode mode);
+
+    /**
+     * @brief Flush every change made to the table to storage.
+     * @details Changes are visible to every other process as soon as they are made. Flushing only matters for
+     *          surviving a crash.
+     * @param policy How thoroughly the file is flushed.
+     * @throw std::runtime_error If flushing failed.
+     */
+    void flush(const sync_policy policy);
+  };
+
+}
+
+#endif
@@ -9,12 +9,16 @@
 #define MEGATECH_TTT_STRATEGY_HPP
 
 #include <cstddef>
+#include <cinttypes>
 
-#include <random>
+#include <chrono>
 #include <limits>
-#include <vector>
+#include <memory>
 
+#include "details/prng.hpp"
+#include "details/search.hpp"
 #include "details/state.hpp"
+#include "details/solver.hpp"
 
 namespace megatech::ttt {
 
@@ -36,6 +40,27 @@ namespace megatech::ttt {
     std::size_t row;
   };
 
+  /**
+   * @brief Algorithms that a strategy can use to select moves.
+   */
+  enum class strategy_algorithm : std::uint32_t {
+    /**
+     * @brief A fixed sequence of rules (win, block, block forks, center, corners, edges).
+     */
+    heuristic = 0,
+
+    /**
+     * @brief A negamax search with alpha-beta pruning and a transposition table that always selects an optimal move.
+     */
+    negamax = 1,
+
+    /**
+     * @brief A lookup in a table of optimal moves that is generated at compile time. When several moves are equally
+     *        good one of them is selected at random.
+     */
+    book = 2
+  };
+
   /**
    * @brief An object representing a strategy for the second player (O) of a Tic-Tac-Toe game.
    */
@@ -43,32 +68,70 @@ namespace megatech::ttt {
   private:
     static constexpr cell_location INVALID_LOCATION{ std::numeric_limits<std::size_t>::max(),
                                                      std::numeric_limits<std::size_t>::max() };
+    static constexpr std::uint32_t EDGE_CELLS{ 0x00'00'00'aa };
+    static constexpr std::uint32_t CORNER_CELLS{ 0x00'00'01'45 };
 
     // Play selection CAN modify the state of this object, but the PRNG state is never exposed in the interface of
     // strategy.
-    mutable std::default_random_engine m_prng{ };
-
-    cell_location find_edge(const details::state& st) const;
-    cell_location find_corner(const details::state& st) const;
+    mutable details::prng m_prng{ 0 };
+    strategy_algorithm m_algorithm{ strategy_algorithm::heuristic };
+    // Like the PRNG, the solver's transposition table is an implementation detail that persists between plays. Only
+    // negamax strategies use it so the other algorithms never allocate it.
+    mutable std::unique_ptr<details::solver> m_solver{ };
+    mutable std::unique_ptr<details::iterative_search<details::state>> m_search{ };
+
+    details::solver& solver() const;
+    details::iterative_search<details::state>& search() const;
+
+    // Pick a uniformly random member of the set without allocating. Returns INVALID_LOCATION if the set is empty.
+    cell_location select(const details::cell_set cells) const;
+    details::cell_set find_edges(const details::state& st) const;
+    details::cell_set find_corners(const details::state& st) const;
     cell_location find_opposite_corner(const details::state& st, const cell_location& last) const;
-    std::vector<cell_location> find_empty_locations(const details::state& st) const;
     bool would_win(const details::state& st, const cell_location& next) const;
     bool would_lose(const details::state& st, const cell_location& next) const;
     cell_location find_win(const details::state& st) const;
-    std::vector<cell_location> find_all_blocks(const details::state& st) const;
     cell_location find_block(const details::state& st) const;
-    cell_location find_fork_block(const details::state& st) const;
+    details::cell_set heuristic_moves(const details::state& st, const cell_location& last) const;
   public:
     /**
      * @brief Create a new strategy object.
+     * @details The new strategy uses strategy_algorithm::heuristic. The random seed is taken from the current time.
      */
     strategy();
 
+    /**
+     * @brief Create a new strategy object that uses the given algorithm.
+     * @details The random seed is taken from the current time.
+     * @param algorithm The algorithm used to select moves.
+     * @throw std::runtime_error If the algorithm is ill formed.
+     */
+    explicit strategy(const strategy_algorithm algorithm);
+
+    /**
+     * @brief Create a new strategy object with a fixed random seed.
+     * @details The new strategy uses strategy_algorithm::heuristic. Two strategies created with the same seed choose
+     *          the same sequence of moves given the same sequence of states, regardless of platform or toolchain.
+     * @param seed The seed used for every random choice made by the strategy.
+     */
+    explicit strategy(const std::uint64_t seed);
+
+    /**
+     * @brief Create a new strategy object that uses the given algorithm and a fixed random seed.
+     * @details Two strategies created with the same algorithm and seed choose the same sequence of moves given the
+     *          same sequence of states, regardless of platform or toolchain.
+     * @param algorithm The algorithm used to select moves.
+     * @param seed The seed used for every random choice made by the strategy.
+     * @throw std::runtime_error If the algorithm is ill formed.
+     */
+    strategy(const strategy_algorithm algorithm, const std::uint64_t seed);
+
     /**
      * @brief Copy a strategy object from another.
+     * @details Only strategy_algorithm::negamax strategies have a transposition table to copy.
      * @param other The strategy to copy.
      */
-    strategy(const strategy& other) = default;
+    strategy(const strategy& other);
 
     /**
      * @brief Move a strategy object from another.
@@ -83,10 +146,11 @@ namespace megatech::ttt {
 
     /**
      * @brief Copy a strategy object from another.
+     * @details Only strategy_algorithm::negamax strategies have a transposition table to copy.
      * @param rhs The strategy to copy.
      * @return A reference to the copied to strategy.
      */
-    strategy& operator=(const strategy& rhs) = default;
+    strategy& operator=(const strategy& rhs);
 
     /**
      * @brief Move a strategy object from another.
@@ -126,6 +190,53 @@ namespace megatech::ttt {
      * @throw std::runtime_error If the strategy fails to find a valid location.
      */
     cell_location run(const details::state& st, const cell_location& last) const;
+
+    /**
+     * @brief Apply the strategy within a time and node budget and choose a cell location to mark for O.
+     * @details strategy_algorithm::negamax uses an iterative deepening search that returns the best move found when
+     *          the budget runs out. A budget large enough to search every line of play selects an optimal move. The
+     *          other algorithms already run in constant time and ignore the budget.
+     * @param g The game to base the location on.
+     * @param last The location of the last mark made by the X player.
+     * @param budget The maximum amount of time to spend choosing a location.
+     * @param node_limit The maximum number of game tree nodes to visit.
+     * @throw std::runtime_error If the strategy fails to find a valid location.
+     */
+    cell_location run(const game& g, const cell_location& last, const std::chrono::steady_clock::duration budget,
+                      const std::size_t node_limit = details::iterative_search<details::state>::UNLIMITED_NODES) const;
+
+    /**
+     * @brief Apply the strategy within a time and node budget and choose a cell location to mark for O.
+     * @details strategy_algorithm::negamax uses an iterative deepening search that returns the best move found when
+     *          the budget runs out. A budget large enough to search every line of play selects an optimal move. The
+     *          other algorithms already run in constant time and ignore the budget.
+     * @param st The state to base the location on.
+     * @param last The location of the last mark made by the X player.
+     * @param budget The maximum amount of time to spend choosing a location.
+     * @param node_limit The maximum number of game tree nodes to visit.
+     * @throw std::runtime_error If the strategy fails to find a valid location.
+     */
+    cell_location run(const details::state& st, const cell_location& last,
+                      const std::chrono::steady_clock::duration budget,
+                      const std::size_t node_limit = details::iterative_search<details::state>::UNLIMITED_NODES) const;
+
+    /**
+     * @brief Find every cell location that the strategy could choose for O.
+     * @details run() selects one member of this set at random. The set has a single member whenever the strategy
+     *          does not need to break a tie. Finding the candidates never changes the random state of the strategy.
+     * @param st The state to base the locations on.
+     * @param last The location of the last mark made by the X player.
+     * @return A cell_set containing each cell that the strategy could mark. If the strategy fails to find a valid
+     *         location, the set is empty.
+     * @throw std::runtime_error If the algorithm is strategy_algorithm::negamax and the game has already ended.
+     */
+    details::cell_set candidates(const details::state& st, const cell_location& last) const;
+
+    /**
+     * @brief Retrieve the algorithm used by the strategy.
+     * @return The strategy's algorithm.
+     */
+    strategy_algorithm algorithm() const;
   };
 
 }
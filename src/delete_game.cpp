@@ -10,6 +10,7 @@
 #include <iostream>
 
 #include <megatech/ttt/game.hpp>
+#include <megatech/ttt/details/lockfile.hpp>
 #include <megatech/ttt/utility.hpp>
 
 void display_help(const std::string& name, const std::string& message) {
@@ -28,9 +29,12 @@ int main(int argc, char** argv) {
     auto stat = std::filesystem::status(game_path);
     if (std::filesystem::exists(stat))
     {
+      // Hold the lock across both the check and the removal so that no other program can open the file in between.
+      auto lock = megatech::ttt::details::lockfile{ game_path };
+      lock.lock();
       try
       {
-        auto g = megatech::ttt::game{ game_path };
+        auto g = megatech::ttt::game{ game_path, megatech::ttt::open_mode::read_only };
       }
       catch (const std::runtime_error& err)
       {
@@ -25,7 +25,7 @@ int main(int argc, char** argv) {
       return res;
     }
     auto game_path = megatech::ttt::find_home_directory() / megatech::ttt::DEFAULT_GAME_NAME;
-    auto g = megatech::ttt::game{ game_path };
+    auto g = megatech::ttt::game{ game_path, megatech::ttt::open_mode::read_only };
     std::cout << g << std::endl;
   }
   catch (const std::exception& err)
@@ -0,0 +1,87 @@
+/**
+ * @file generate_tablebase.cpp
+ * @brief Tablebase generation application.
+ * @author Alexander Rothman <gnomesort@megate.ch>
+ * @date 2024
+ * @copyright AGPL-3.0+
+ */
+#include <cstddef>
+
+#include <chrono>
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+#include <megatech/ttt/utility.hpp>
+#include <megatech/ttt/details/rank.hpp>
+#include <megatech/ttt/details/state.hpp>
+#include <megatech/ttt/details/tablebase.hpp>
+
+void display_help(const std::string& name, const std::string& message) {
+  std::cerr << message << std::endl;
+  std::cerr << "USAGE: " << name << " <PATH> [ENCODING]" << std::endl;
+  std::cerr << "\tENCODING is \"distance\" or \"value\". The default is \"distance\"." << std::endl;
+}
+
+int main(int argc, char** argv) {
+  try
+  {
+    if (auto res = megatech::ttt::initialize(argc, argv); res)
+    {
+      return res;
+    }
+    if (argc < 2)
+    {
+      display_help(argv[0], "A tablebase path is required.");
+      return 1;
+    }
+    const auto path = std::filesystem::path{ argv[1] };
+    auto encoding = megatech::ttt::details::tablebase_encoding::distance;
+    if (argc > 2)
+    {
+      const auto name = std::string{ argv[2] };
+      if (name == "value")
+      {
+        encoding = megatech::ttt::details::tablebase_encoding::value;
+      }
+      else if (name != "distance")
+      {
+        display_help(argv[0], "The encoding must be \"distance\" or \"value\".");
+        return 1;
+      }
+    }
+    const auto start = std::chrono::steady_clock::now();
+    megatech::ttt::details::write_tablebase(path, encoding);
+    const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    // Read the file back so that the summary reflects what was actually written.
+    const auto tb = megatech::ttt::details::tablebase{ path };
+    auto wins = std::size_t{ 0 };
+    auto losses = std::size_t{ 0 };
+    auto draws = std::size_t{ 0 };
+    for (auto r = std::size_t{ 0 }; r < megatech::ttt::details::REACHABLE_BOARD_COUNT; ++r)
+    {
+      switch (tb.probe(megatech::ttt::details::unrank(r)).value)
+      {
+      case megatech::ttt::details::game_value::win:
+        ++wins;
+        break;
+      case megatech::ttt::details::game_value::loss:
+        ++losses;
+        break;
+      default:
+        ++draws;
+        break;
+      }
+    }
+    std::cout << "Wrote " << megatech::ttt::details::REACHABLE_BOARD_COUNT << " positions to " << path << " ("
+              << std::filesystem::file_size(path) << " bytes) in " << elapsed << " ms." << std::endl;
+    std::cout << "Wins: " << wins << ", losses: " << losses << ", draws: " << draws << std::endl;
+  }
+  catch (const std::exception& err)
+  {
+    display_help(argv[0], err.what());
+    return 1;
+  }
+  return 0;
+}
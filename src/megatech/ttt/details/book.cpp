@@ -0,0 +1,88 @@
+/**
+ * @file book.cpp
+ * @brief Precomputed optimal move table.
+ * @author Alexander Rothman <gnomesort@megate.ch>
+ * @date 2024
+ * @copyright AGPL-3.0+
+ */
+#include "megatech/ttt/details/book.hpp"
+
+#include <cstddef>
+#include <cinttypes>
+
+#include <array>
+
+#include "megatech/ttt/details/bitboard.hpp"
+#include "megatech/ttt/details/rank.hpp"
+
+namespace {
+
+  struct book_tables final {
+    std::array<std::int8_t, megatech::ttt::details::BOARD_COUNT> scores;
+    std::array<std::uint16_t, megatech::ttt::details::BOARD_COUNT> moves;
+  };
+
+  // Scores are stored with an offset so that a zero initialized entry indicates an unsolved board.
+  constexpr int SCORE_OFFSET{ 64 };
+
+  // Solve the given board and record every optimal move wherever it is O's turn. Scores follow the same rules as
+  // details::solver. Only boards reachable from the input are visited and each of those is solved exactly once.
+  // Compilers limit the amount of work done during constant evaluation so enumerating all 3^9 boards (most of which
+  // can't occur in a game) isn't an option.
+  constexpr int solve(book_tables& tables, const megatech::ttt::details::bitboard& board) {
+    const auto index = megatech::ttt::details::board_index(board);
+    if (tables.scores[index])
+    {
+      return tables.scores[index] - SCORE_OFFSET;
+    }
+    const auto filled = static_cast<int>(board.filled_cells());
+    auto best = 0;
+    if (board.winner() != megatech::ttt::cell_contents::empty)
+    {
+      // The player to move lost on the previous turn.
+      best = filled - 11;
+    }
+    else if (filled < 9)
+    {
+      const auto player = board.player_to_move();
+      auto moves = megatech::ttt::details::cell_set{ };
+      best = -100;
+      for (const auto cell : board.empty_cells())
+      {
+        auto next = board;
+        next.cell(cell, player);
+        const auto score = -solve(tables, next);
+        if (score > best)
+        {
+          best = score;
+          moves = { };
+        }
+        if (score == best)
+        {
+          moves.insert(cell);
+        }
+      }
+      if (player == megatech::ttt::cell_contents::o)
+      {
+        tables.moves[index] = static_cast<std::uint16_t>(static_cast<std::uint32_t>(moves));
+      }
+    }
+    tables.scores[index] = static_cast<std::int8_t>(best + SCORE_OFFSET);
+    return best;
+  }
+
+  constexpr std::array<std::uint16_t, megatech::ttt::details::BOARD_COUNT> BOOK = []() {
+    auto tables = book_tables{ };
+    solve(tables, megatech::ttt::details::bitboard{ });
+    return tables.moves;
+  }();
+
+}
+
+namespace megatech::ttt::details {
+
+  cell_set book_moves(const state& st) {
+    return cell_set{ BOOK[board_index(st)] };
+  }
+
+}
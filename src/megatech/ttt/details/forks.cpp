@@ -0,0 +1,83 @@
+/**
+ * @file forks.cpp
+ * @brief Fork detection for the heuristic strategy.
+ * @author Alexander Rothman <gnomesort@megate.ch>
+ * @date 2024
+ * @copyright AGPL-3.0+
+ */
+#include "megatech/ttt/details/forks.hpp"
+
+#include <cinttypes>
+
+#include <array>
+#include <bit>
+
+namespace {
+
+  // For every possible 9-bit plane, the cells that would complete a line already holding two of the plane's marks.
+  // Whether those cells are actually empty is up to the caller.
+  constexpr std::array<std::uint16_t, 512> THREAT_CELLS = []() {
+    auto res = std::array<std::uint16_t, 512>{ };
+    for (auto plane = std::uint32_t{ 0 }; plane < res.size(); ++plane)
+    {
+      for (const auto line : megatech::ttt::details::cell_set::LINES)
+      {
+        if (std::popcount(plane & line) == 2)
+        {
+          res[plane] |= line & ~plane;
+        }
+      }
+    }
+    return res;
+  }();
+
+  // Find every empty cell that would complete a line for the player with the given plane.
+  std::uint32_t threats(const std::uint32_t player, const std::uint32_t empty) {
+    return THREAT_CELLS[player] & empty;
+  }
+
+}
+
+namespace megatech::ttt::details {
+
+  cell_set fork_blocks(const state& st) {
+    // This bears some explanation.
+    // A fork is a position originating on turn 3 or turn 5 where a mistake by
+    // O allows X to win. In a fork position X can win in two different ways
+    // which prevents a block by O. Such a position arises two turns after the
+    // mistake by O and therefore requires additional foresight to prevent.
+    // A position is excluded from being a fork if O can win before X in the
+    // fork position.
+    //
+    // Rather than copying states and rescanning the board, each candidate is checked by counting threats on the
+    // 9-bit occupancy planes. At most 9 * 8 pairs of plies are considered and each of those costs two table lookups.
+    const auto x = static_cast<std::uint32_t>(st.x_cells());
+    const auto o = static_cast<std::uint32_t>(st.o_cells());
+    const auto empty = static_cast<std::uint32_t>(st.empty_cells());
+    auto res = cell_set{ };
+    for (const auto cell : st.empty_cells())
+    {
+      const auto next_o = o | (1u << cell);
+      const auto next_empty = empty & ~(1u << cell);
+      auto fork = false;
+      for (auto replies = next_empty; replies && !fork; replies &= replies - 1)
+      {
+        // Isolate the lowest remaining reply.
+        const auto reply = replies & -replies;
+        const auto next_x = x | reply;
+        const auto remaining = next_empty & ~reply;
+        // A position is only a fork if O would need to block more than one win by X AND O cannot win on the next
+        // turn.
+        const auto x_threats = std::popcount(next_x) > 2 ? threats(next_x, remaining) : 0;
+        const auto o_threats = std::popcount(next_o) > 1 ? threats(next_o, remaining) : 0;
+        fork = std::popcount(x_threats) > 1 && !o_threats;
+      }
+      if (!fork)
+      {
+        res.insert(cell);
+      }
+    }
+    return res;
+  }
+
+}
@@ -0,0 +1,132 @@
+/**
+ * @file mapped_file.cpp
+ * @brief Memory mapped file access.
+ * @author Alexander Rothman <gnomesort@megate.ch>
+ * @date 2024
+ * @copyright AGPL-3.0+
+ */
+#include "megatech/ttt/details/mapped_file.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+#include "configuration.hpp"
+
+#if defined(CONFIGURATION_OPERATING_SYSTEM_POSIX)
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+namespace megatech::ttt::details {
+
+  bool mapped_file::is_available() {
+#if defined(CONFIGURATION_OPERATING_SYSTEM_POSIX)
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  mapped_file::mapped_file(const std::filesystem::path& path, const bool writable) {
+#if defined(CONFIGURATION_OPERATING_SYSTEM_POSIX)
+    m_descriptor = open(path.c_str(), writable ? O_RDWR : O_RDONLY);
+    if (m_descriptor < 0)
+    {
+      throw std::runtime_error{ "The file could not be opened." };
+    }
+    struct stat info { };
+    if (fstat(m_descriptor, &info) || info.st_size <= 0)
+    {
+      close();
+      throw std::runtime_error{ "The file could not be mapped because it is empty." };
+    }
+    m_size = static_cast<std::size_t>(info.st_size);
+    auto mapping = mmap(nullptr, m_size, writable ? PROT_READ | PROT_WRITE : PROT_READ,
+                        writable ? MAP_SHARED : MAP_PRIVATE, m_descriptor, 0);
+    if (mapping == MAP_FAILED)
+    {
+      close();
+      throw std::runtime_error{ "The file could not be mapped." };
+    }
+    m_data = static_cast<unsigned char*>(mapping);
+    // The mapping remains valid without the descriptor. It is only kept to flush metadata.
+    if (!writable)
+    {
+      ::close(std::exchange(m_descriptor, -1));
+    }
+#else
+    static_cast<void>(path);
+    static_cast<void>(writable);
+    throw std::runtime_error{ "Memory mapped files are unavailable on this system." };
+#endif
+  }
+
+  mapped_file::mapped_file(mapped_file&& other) noexcept : m_data{ std::exchange(other.m_data, nullptr) },
+                                                           m_size{ std::exchange(other.m_size, 0) },
+                                                           m_descriptor{ std::exchange(other.m_descriptor, -1) } { }
+
+  mapped_file::~mapped_file() noexcept {
+    close();
+  }
+
+  mapped_file& mapped_file::operator=(mapped_file&& rhs) noexcept {
+    if (this != &rhs)
+    {
+      close();
+      m_data = std::exchange(rhs.m_data, nullptr);
+      m_size = std::exchange(rhs.m_size, 0);
+      m_descriptor = std::exchange(rhs.m_descriptor, -1);
+    }
+    return *this;
+  }
+
+  bool mapped_file::is_open() const {
+    return m_data;
+  }
+
+  unsigned char* mapped_file::data() {
+    return m_data;
+  }
+
+  const unsigned char* mapped_file::data() const {
+    return m_data;
+  }
+
+  std::size_t mapped_file::size() const {
+    return m_size;
+  }
+
+  void mapped_file::flush(const bool metadata) {
+    if (!m_data)
+    {
+      throw std::runtime_error{ "There is no mapped file to flush." };
+    }
+#if defined(CONFIGURATION_OPERATING_SYSTEM_POSIX)
+    if (msync(m_data, m_size, MS_SYNC) || (metadata && m_descriptor >= 0 && fsync(m_descriptor)))
+    {
+      throw std::runtime_error{ "The mapped file could not be flushed." };
+    }
+#else
+    static_cast<void>(metadata);
+#endif
+  }
+
+  void mapped_file::close() noexcept {
+#if defined(CONFIGURATION_OPERATING_SYSTEM_POSIX)
+    if (m_data)
+    {
+      munmap(m_data, m_size);
+    }
+    if (m_descriptor >= 0)
+    {
+      ::close(m_descriptor);
+    }
+#endif
+    m_data = nullptr;
+    m_size = 0;
+    m_descriptor = -1;
+  }
+
+}
@@ -0,0 +1,113 @@
+/**
+ * @file rank.cpp
+ * @brief Dense indexing of game states.
+ * @author Alexander Rothman <gnomesort@megate.ch>
+ * @date 2024
+ * @copyright AGPL-3.0+
+ */
+#include "megatech/ttt/details/rank.hpp"
+
+#include <stdexcept>
+
+namespace {
+
+  constexpr std::uint16_t UNREACHABLE{ 0xff'ff };
+
+  struct rank_tables final {
+    std::array<std::uint16_t, megatech::ttt::details::BOARD_COUNT> ranks;
+    std::array<std::uint32_t, megatech::ttt::details::REACHABLE_BOARD_COUNT> x_planes;
+    std::array<std::uint32_t, megatech::ttt::details::REACHABLE_BOARD_COUNT> o_planes;
+  };
+
+  // Mark every board reachable from the given board. Reachable boards are temporarily marked with a rank of 0.
+  constexpr void mark_reachable(rank_tables& tables, const megatech::ttt::details::bitboard& board) {
+    const auto index = megatech::ttt::details::board_index(board);
+    if (tables.ranks[index] != UNREACHABLE)
+    {
+      return;
+    }
+    tables.ranks[index] = 0;
+    if (board.winner() != megatech::ttt::cell_contents::empty)
+    {
+      return;
+    }
+    const auto player = board.player_to_move();
+    for (const auto cell : board.empty_cells())
+    {
+      auto next = board;
+      next.cell(cell, player);
+      mark_reachable(tables, next);
+    }
+  }
+
+  constexpr rank_tables RANK_TABLES = []() {
+    auto res = rank_tables{ };
+    res.ranks.fill(UNREACHABLE);
+    mark_reachable(res, megatech::ttt::details::bitboard{ });
+    // Visiting boards in ascending order of their base 3 index assigns ranks in the same order. The planes of each
+    // board are recovered from the digits of the index.
+    auto next = std::uint16_t{ 0 };
+    for (auto index = std::size_t{ 0 }; index < res.ranks.size(); ++index)
+    {
+      if (res.ranks[index] == UNREACHABLE)
+      {
+        continue;
+      }
+      res.ranks[index] = next;
+      for (auto i = std::size_t{ 0 }, rest = index; i < 9; ++i, rest /= 3)
+      {
+        res.x_planes[next] |= (rest % 3 == 1) << i;
+        res.o_planes[next] |= (rest % 3 == 2) << i;
+      }
+      ++next;
+    }
+    return res;
+  }();
+
+}
+
+namespace megatech::ttt::details {
+
+  std::size_t board_index(const state& st) {
+    return board_index(bitboard{ st });
+  }
+
+  std::size_t rank(const state& st) {
+    const auto res = RANK_TABLES.ranks[board_index(st)];
+    if (res == UNREACHABLE)
+    {
+      throw std::runtime_error{ "The game board can not occur in a game." };
+    }
+    return res;
+  }
+
+  state unrank(const std::size_t index) {
+    if (index >= REACHABLE_BOARD_COUNT)
+    {
+      throw std::runtime_error{ "The rank is out of bounds." };
+    }
+    auto res = static_cast<state>(bitboard{ cell_set{ RANK_TABLES.x_planes[index] },
+                                            cell_set{ RANK_TABLES.o_planes[index] } });
+    switch (res.winner())
+    {
+    case cell_contents::x:
+      res.phase(game_phase::win_x);
+      break;
+    case cell_contents::o:
+      res.phase(game_phase::win_o);
+      break;
+    default:
+      if (res.is_board_full())
+      {
+        res.phase(game_phase::draw);
+      }
+      else if (res.count_x() > res.count_o())
+      {
+        res.phase(game_phase::turn_o);
+      }
+      break;
+    }
+    return res;
+  }
+
+}
@@ -0,0 +1,97 @@
+/**
+ * @file replace_file.cpp
+ * @brief Atomic file replacement.
+ * @author Alexander Rothman <gnomesort@megate.ch>
+ * @date 2024
+ * @copyright AGPL-3.0+
+ */
+#include "megatech/ttt/details/replace_file.hpp"
+
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+#include "configuration.hpp"
+
+#if defined(CONFIGURATION_OPERATING_SYSTEM_POSIX)
+  #include <fcntl.h>
+  #include <unistd.h>
+#endif
+
+namespace megatech::ttt::details {
+
+  void replace_file(const std::filesystem::path& path, const std::vector<unsigned char>& contents,
+                    const sync_policy policy) {
+    auto temporary = path;
+    temporary.replace_filename(std::string{ ".~new" }.append(path.filename().string()));
+#if defined(CONFIGURATION_OPERATING_SYSTEM_POSIX)
+    const auto fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    if (fd < 0)
+    {
+      throw std::runtime_error{ "The temporary file could not be created." };
+    }
+    auto written = std::size_t{ 0 };
+    while (written < contents.size())
+    {
+      const auto res = ::write(fd, contents.data() + written, contents.size() - written);
+      if (res < 0)
+      {
+        break;
+      }
+      written += static_cast<std::size_t>(res);
+    }
+    auto synced = true;
+    switch (policy)
+    {
+    case sync_policy::data:
+#if defined(_POSIX_SYNCHRONIZED_IO) && _POSIX_SYNCHRONIZED_IO > 0
+      synced = !::fdatasync(fd);
+      break;
+#else
+      [[fallthrough]];
+#endif
+    case sync_policy::full:
+      synced = !::fsync(fd);
+      break;
+    default:
+      break;
+    }
+    if (::close(fd) || written < contents.size() || !synced)
+    {
+      std::filesystem::remove_all(temporary);
+      throw std::runtime_error{ "The temporary file could not be written." };
+    }
+    std::filesystem::rename(temporary, path);
+    // The rename itself is only durable once the directory entry is flushed.
+    if (policy == sync_policy::full)
+    {
+      const auto dir = ::open(path.parent_path().c_str(), O_RDONLY);
+      if (dir < 0)
+      {
+        throw std::runtime_error{ "The directory containing the file could not be opened." };
+      }
+      synced = !::fsync(dir);
+      ::close(dir);
+      if (!synced)
+      {
+        throw std::runtime_error{ "The directory containing the file could not be synchronized." };
+      }
+    }
+#else
+    // Standard streams have no way to synchronize with storage so only the rename is guaranteed here.
+    static_cast<void>(policy);
+    {
+      auto f_out = std::ofstream{ temporary, std::ios::binary | std::ios::trunc };
+      f_out.write(reinterpret_cast<const char*>(contents.data()), static_cast<std::streamsize>(contents.size()));
+      f_out.close();
+      if (!f_out)
+      {
+        std::filesystem::remove_all(temporary);
+        throw std::runtime_error{ "The temporary file could not be written." };
+      }
+    }
+    std::filesystem::rename(temporary, path);
+#endif
+  }
+
+}
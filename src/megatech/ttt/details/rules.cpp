@@ -0,0 +1,84 @@
+/**
+ * @file rules.cpp
+ * @brief The rules of Tic-Tac-Toe.
+ * @author Alexander Rothman <gnomesort@megate.ch>
+ * @date 2024
+ * @copyright AGPL-3.0+
+ */
+#include "megatech/ttt/details/rules.hpp"
+
+#include <cassert>
+
+#include <stdexcept>
+
+#include "megatech/ttt/enums.hpp"
+
+namespace {
+
+  void update_play_state(megatech::ttt::details::state& st, const std::size_t column, const std::size_t row) {
+    // Only the lines passing through the most recently marked cell can have been completed by the last turn.
+    switch (const auto value = st.cell(column, row); value)
+    {
+    case megatech::ttt::cell_contents::x:
+      if (st.completes_line(column, row, value))
+      {
+        st.phase(megatech::ttt::game_phase::win_x);
+        return;
+      }
+      break;
+    case megatech::ttt::cell_contents::o:
+      if (st.completes_line(column, row, value))
+      {
+        st.phase(megatech::ttt::game_phase::win_o);
+        return;
+      }
+      break;
+    default:
+      break;
+    }
+    if (st.is_board_full())
+    {
+      st.phase(megatech::ttt::game_phase::draw);
+      return;
+    }
+    switch (st.phase())
+    {
+    case megatech::ttt::game_phase::turn_x:
+      st.phase(megatech::ttt::game_phase::turn_o);
+      return;
+    case megatech::ttt::game_phase::turn_o:
+      st.phase(megatech::ttt::game_phase::turn_x);
+      return;
+    default:
+      // Unless something is really broken this can't happen.
+      assert(((void) "Unreachable", false));
+    }
+  }
+
+}
+
+namespace megatech::ttt::details {
+
+  bool take_turn(state& st, const std::size_t column, const std::size_t row) {
+    auto value = cell_contents::empty;
+    switch (st.phase())
+    {
+    case game_phase::turn_x:
+      value = cell_contents::x;
+      break;
+    case game_phase::turn_o:
+      value = cell_contents::o;
+      break;
+    default:
+      return false;
+    }
+    if (st.cell(column, row) != cell_contents::empty)
+    {
+      throw std::runtime_error{ "The desired turn was invalid because the cell was already filled." };
+    }
+    st.cell(column, row, value);
+    update_play_state(st, column, row);
+    return true;
+  }
+
+}
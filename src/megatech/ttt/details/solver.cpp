@@ -0,0 +1,185 @@
+/**
+ * @file solver.cpp
+ * @brief Perfect play game tree solver.
+ * @author Alexander Rothman <gnomesort@megate.ch>
+ * @date 2024
+ * @copyright AGPL-3.0+
+ */
+#include "megatech/ttt/details/solver.hpp"
+
+#include <array>
+#include <stdexcept>
+#include <algorithm>
+
+namespace {
+
+  // Searching the center first, then the corners, and finally the edges produces early cutoffs in most positions.
+  constexpr std::array<std::size_t, 9> MOVE_ORDER{ 4, 0, 2, 6, 8, 1, 3, 5, 7 };
+
+  megatech::ttt::cell_contents player_to_move(const megatech::ttt::details::state& st) {
+    return st.count_x() > st.count_o() ? megatech::ttt::cell_contents::o : megatech::ttt::cell_contents::x;
+  }
+
+  megatech::ttt::cell_contents opponent(const megatech::ttt::cell_contents player) {
+    return player == megatech::ttt::cell_contents::x ? megatech::ttt::cell_contents::o :
+                                                       megatech::ttt::cell_contents::x;
+  }
+
+  void validate_root(const megatech::ttt::details::state& st) {
+    if (st.winner() != megatech::ttt::cell_contents::empty || st.is_board_full())
+    {
+      throw std::runtime_error{ "The game has already ended." };
+    }
+  }
+
+}
+
+namespace megatech::ttt::details {
+
+  const solver::entry* solver::probe(const state& st) const {
+    const auto board = st.board();
+    for (auto i = std::size_t{ 0 }, slot = st.hash() & (TABLE_SIZE - 1); i < MAX_PROBES;
+         ++i, slot = (slot + 1) & (TABLE_SIZE - 1))
+    {
+      if (m_table[slot].board == board)
+      {
+        return &m_table[slot];
+      }
+      if (m_table[slot].board == EMPTY_SLOT)
+      {
+        break;
+      }
+    }
+    return nullptr;
+  }
+
+  void solver::store(const state& st, const int score, const bound type) {
+    const auto board = st.board();
+    const auto home = st.hash() & (TABLE_SIZE - 1);
+    for (auto i = std::size_t{ 0 }, slot = home; i < MAX_PROBES; ++i, slot = (slot + 1) & (TABLE_SIZE - 1))
+    {
+      if (m_table[slot].board == board || m_table[slot].board == EMPTY_SLOT)
+      {
+        m_table[slot] = { board, static_cast<std::int8_t>(score), type };
+        return;
+      }
+    }
+    // Every slot near the home slot is taken by another board so the home slot is replaced.
+    m_table[home] = { board, static_cast<std::int8_t>(score), type };
+  }
+
+  int solver::negamax(state& st, const cell_contents player, int alpha, int beta) {
+    ++m_nodes;
+    const auto original_alpha = alpha;
+    if (const auto found = probe(st); found)
+    {
+      const auto score = found->score;
+      switch (found->type)
+      {
+      case bound::exact:
+        return score;
+      case bound::lower:
+        alpha = std::max(alpha, static_cast<int>(score));
+        break;
+      case bound::upper:
+        beta = std::min(beta, static_cast<int>(score));
+        break;
+      }
+      if (alpha >= beta)
+      {
+        return score;
+      }
+    }
+    const auto filled = static_cast<int>(st.filled_cells());
+    const auto empty = st.empty_cells();
+    auto best = -INFINITE_SCORE;
+    for (const auto cell : MOVE_ORDER)
+    {
+      if (!empty.contains(cell))
+      {
+        continue;
+      }
+      auto score = 0;
+      if (st.completes_line(cell % 3, cell / 3, player))
+      {
+        score = 10 - filled;
+      }
+      else if (filled + 1 < 9)
+      {
+        st.cell(cell % 3, cell / 3, player);
+        score = -negamax(st, opponent(player), -beta, -alpha);
+        st.cell(cell % 3, cell / 3, cell_contents::empty);
+      }
+      best = std::max(best, score);
+      alpha = std::max(alpha, score);
+      if (alpha >= beta)
+      {
+        break;
+      }
+    }
+    auto type = bound::exact;
+    if (best <= original_alpha)
+    {
+      type = bound::upper;
+    }
+    else if (best >= beta)
+    {
+      type = bound::lower;
+    }
+    store(st, best, type);
+    return best;
+  }
+
+  solver::solver() : m_table(TABLE_SIZE, entry{ EMPTY_SLOT, 0, bound::exact }) { }
+
+  int solver::evaluate(const state& st) {
+    validate_root(st);
+    auto cpy = st;
+    return negamax(cpy, player_to_move(st), -INFINITE_SCORE, INFINITE_SCORE);
+  }
+
+  std::size_t solver::best_move(const state& st) {
+    validate_root(st);
+    const auto player = player_to_move(st);
+    const auto filled = static_cast<int>(st.filled_cells());
+    const auto empty = st.empty_cells();
+    auto cpy = st;
+    auto best = -INFINITE_SCORE;
+    auto res = MOVE_ORDER[0];
+    for (const auto cell : MOVE_ORDER)
+    {
+      if (!empty.contains(cell))
+      {
+        continue;
+      }
+      auto score = 0;
+      if (cpy.completes_line(cell % 3, cell / 3, player))
+      {
+        score = 10 - filled;
+      }
+      else if (filled + 1 < 9)
+      {
+        cpy.cell(cell % 3, cell / 3, player);
+        // Only moves that beat the current best matter at the root so the window is narrowed to (best, infinity).
+        score = -negamax(cpy, opponent(player), -INFINITE_SCORE, -best);
+        cpy.cell(cell % 3, cell / 3, cell_contents::empty);
+      }
+      if (score > best)
+      {
+        best = score;
+        res = cell;
+      }
+    }
+    return res;
+  }
+
+  std::size_t solver::nodes() const {
+    return m_nodes;
+  }
+
+  void solver::clear() {
+    std::fill(m_table.begin(), m_table.end(), entry{ EMPTY_SLOT, 0, bound::exact });
+    m_nodes = 0;
+  }
+
+}
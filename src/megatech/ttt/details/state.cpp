@@ -12,12 +12,161 @@
 #include <array>
 #include <utility>
 
+#include "megatech/ttt/details/planes.hpp"
+
+namespace {
+
+  constexpr std::uint64_t splitmix64(std::uint64_t& x) {
+    auto z = (x += 0x9e'37'79'b9'7f'4a'7c'15);
+    z = (z ^ (z >> 30)) * 0xbf'58'47'6d'1c'e4'e5'b9;
+    z = (z ^ (z >> 27)) * 0x94'd0'49'bb'13'31'11'eb;
+    return z ^ (z >> 31);
+  }
+
+  // One key for every cell and every 2-bit cell value. Empty cells contribute nothing so that the hash of an empty
+  // board is 0.
+  constexpr auto ZOBRIST_KEYS = []() {
+    auto res = std::array<std::array<std::uint32_t, 4>, 9>{ };
+    auto seed = std::uint64_t{ 0x74'74'74'0d'0a'1a'0a'89 };
+    for (auto& cell : res)
+    {
+      for (auto value = std::size_t{ 1 }; value < cell.size(); ++value)
+      {
+        cell[value] = static_cast<std::uint32_t>(splitmix64(seed) >> 32);
+      }
+    }
+    return res;
+  }();
+
+  // The combined keys of every possible row value. A whole board is hashed by combining three lookups.
+  constexpr auto ZOBRIST_ROW_TABLES = []() {
+    auto res = std::array<std::array<std::uint32_t, 64>, 3>{ };
+    for (auto row = std::size_t{ 0 }; row < res.size(); ++row)
+    {
+      for (auto bits = std::uint32_t{ 0 }; bits < res[row].size(); ++bits)
+      {
+        for (auto column = std::size_t{ 0 }; column < 3; ++column)
+        {
+          res[row][bits] ^= ZOBRIST_KEYS[row * 3 + column][(bits >> (column * 2)) & 0x03];
+        }
+      }
+    }
+    return res;
+  }();
+
+  constexpr std::size_t SYMMETRY_COUNT{ 8 };
+
+  constexpr std::size_t transform_index(const std::size_t sym, const std::size_t index) {
+    const auto column = index % 3;
+    const auto row = index / 3;
+    switch (sym)
+    {
+    case 1:
+      return column * 3 + (2 - row);
+    case 2:
+      return (2 - row) * 3 + (2 - column);
+    case 3:
+      return (2 - column) * 3 + row;
+    case 4:
+      return row * 3 + (2 - column);
+    case 5:
+      return (2 - row) * 3 + column;
+    case 6:
+      return column * 3 + row;
+    case 7:
+      return (2 - column) * 3 + (2 - row);
+    default:
+      return index;
+    }
+  }
+
+  // Each row of the board occupies 6 bits. For every symmetry and every row, this table maps all 64 possible row
+  // values to the bits that row contributes to the transformed board. A whole board is transformed by combining
+  // three lookups.
+  constexpr auto SYMMETRY_TABLES = []() {
+    auto res = std::array<std::array<std::array<std::uint32_t, 64>, 3>, SYMMETRY_COUNT>{ };
+    for (auto sym = std::size_t{ 0 }; sym < SYMMETRY_COUNT; ++sym)
+    {
+      for (auto row = std::size_t{ 0 }; row < 3; ++row)
+      {
+        for (auto bits = std::uint32_t{ 0 }; bits < 64; ++bits)
+        {
+          for (auto column = std::size_t{ 0 }; column < 3; ++column)
+          {
+            const auto value = (bits >> (column * 2)) & 0x03;
+            res[sym][row][bits] |= value << (transform_index(sym, row * 3 + column) * 2);
+          }
+        }
+      }
+    }
+    return res;
+  }();
+
+}
+
 namespace megatech::ttt::details {
 
-  state::state(const std::uint32_t data) : m_data{ data } {
+  symmetry inverse(const symmetry sym) {
+    switch (sym)
+    {
+    case symmetry::rotate_90:
+      return symmetry::rotate_270;
+    case symmetry::rotate_270:
+      return symmetry::rotate_90;
+    case symmetry::identity:
+    case symmetry::rotate_180:
+    case symmetry::reflect_horizontal:
+    case symmetry::reflect_vertical:
+    case symmetry::reflect_left_diagonal:
+    case symmetry::reflect_right_diagonal:
+      return sym;
+    default:
+      throw std::runtime_error{ "The symmetry was invalid." };
+    }
+  }
+
+  std::size_t transform_cell(const symmetry sym, const std::size_t index) {
+    if (static_cast<std::size_t>(sym) >= SYMMETRY_COUNT)
+    {
+      throw std::runtime_error{ "The symmetry was invalid." };
+    }
+    if (index > 8)
+    {
+      throw std::runtime_error{ "The cell index is out of bounds." };
+    }
+    return transform_index(static_cast<std::size_t>(sym), index);
+  }
+
+  const std::array<cell_set, state::LINE_COUNT>& state::lines() {
+    // cell_set::LINES is the only definition of the winning lines. It must agree with the board masks used by the row,
+    // column, and diagonal queries.
+    static_assert(cell_set::LINES == std::array<std::uint32_t, LINE_COUNT>{
+      compress_plane(BOARD_UPPER_ROW_MASK), compress_plane(BOARD_MIDDLE_ROW_MASK),
+      compress_plane(BOARD_BOTTOM_ROW_MASK), compress_plane(BOARD_LEFT_COLUMN_MASK),
+      compress_plane(BOARD_CENTER_COLUMN_MASK), compress_plane(BOARD_RIGHT_COLUMN_MASK),
+      compress_plane(BOARD_LEFT_TO_RIGHT_DIAGONAL_MASK), compress_plane(BOARD_RIGHT_TO_LEFT_DIAGONAL_MASK)
+    });
+    static constexpr auto res = []() {
+      auto lines = std::array<cell_set, LINE_COUNT>{ };
+      for (auto i = std::size_t{ 0 }; i < LINE_COUNT; ++i)
+      {
+        lines[i] = cell_set{ cell_set::LINES[i] };
+      }
+      return lines;
+    }();
+    return res;
+  }
+
+  void state::rehash() {
+    m_hash = ZOBRIST_ROW_TABLES[0][m_data & BOARD_UPPER_ROW_MASK] ^
+             ZOBRIST_ROW_TABLES[1][(m_data & BOARD_MIDDLE_ROW_MASK) >> BOARD_MIDDLE_ROW_SHIFT] ^
+             ZOBRIST_ROW_TABLES[2][(m_data & BOARD_BOTTOM_ROW_MASK) >> BOARD_BOTTOM_ROW_SHIFT];
+  }
+
+  state::basic_state(const std::uint32_t data) : m_data{ data } {
     // There are five game phases. Since the enum values are zero based, this means that any value greater than four
     // in the phase bits is invalid.
-    if ((m_data & GAME_PHASE_MASK) >= 0x50'00'00'00)
+    if ((m_data & GAME_PHASE_MASK) >= FIRST_INVALID_PHASE)
     {
       throw std::runtime_error{ "The game phase was invalid." };
     }
@@ -38,6 +187,7 @@ namespace megatech::ttt::details {
         throw std::runtime_error{ "The game board contained an invalid cell." };
       }
     }
+    rehash();
   }
 
   state::operator std::uint32_t() const {
@@ -63,13 +213,26 @@ namespace megatech::ttt::details {
 
   void state::phase(const game_phase gp) {
     const auto gp_bits = static_cast<std::uint32_t>(gp);
-    if (gp_bits >= 0x50'00'00'00)
+    if (gp_bits >= FIRST_INVALID_PHASE)
     {
       throw std::runtime_error{ "The game phase was invalid." };
     }
     m_data = (m_data & ~GAME_PHASE_MASK) | gp_bits;
   }
 
+  std::uint32_t state::hash() const {
+    // Zobrist keys combine linearly so any small group of bits in the raw hash can only take a few of its possible
+    // values over the (very structured) set of reachable boards. The murmur3 finalizer is a cheap bijection that
+    // spreads every input bit across the whole output without affecting the incremental update.
+    auto res = m_hash;
+    res ^= res >> 16;
+    res *= 0x85'eb'ca'6b;
+    res ^= res >> 13;
+    res *= 0xc2'b2'ae'35;
+    res ^= res >> 16;
+    return res;
+  }
+
   std::uint32_t state::board() const {
     return m_data & GAME_BOARD_MASK;
   }
@@ -154,6 +317,87 @@ namespace megatech::ttt::details {
     return (m_data & BOARD_RIGHT_TO_LEFT_DIAGONAL_MASK) == 0x00'00'22'20;
   }
 
+  cell_contents state::winner() const {
+    // Every possible 9-bit plane is mapped to whether or not it contains a complete line.
+    static constexpr auto WINNING_PLANES = []() {
+      auto res = std::array<bool, 512>{ };
+      for (auto plane = std::uint32_t{ 0 }; plane < res.size(); ++plane)
+      {
+        for (const auto line : cell_set::LINES)
+        {
+          res[plane] = res[plane] || (plane & line) == line;
+        }
+      }
+      return res;
+    }();
+    if (WINNING_PLANES[compress_plane(m_data & GAME_BOARD_MASK)])
+    {
+      return cell_contents::x;
+    }
+    if (WINNING_PLANES[compress_plane((m_data >> 1) & GAME_BOARD_MASK)])
+    {
+      return cell_contents::o;
+    }
+    return cell_contents::empty;
+  }
+
+  bool state::completes_line(const std::size_t column, const std::size_t row, const cell_contents value) const {
+    if (column > 2)
+    {
+      throw std::runtime_error{ "The column index is out of bounds." };
+    }
+    if (row > 2)
+    {
+      throw std::runtime_error{ "The row index is out of bounds." };
+    }
+    // Each cell lies on between 2 (edges) and 4 (the center) lines. Cells with fewer than 4 lines repeat their first
+    // line so that every query performs the same fixed number of comparisons.
+    static constexpr auto CELL_LINES = []() {
+      const auto lines = std::array<std::uint32_t, 8>{ BOARD_UPPER_ROW_MASK, BOARD_MIDDLE_ROW_MASK,
+                                                       BOARD_BOTTOM_ROW_MASK, BOARD_LEFT_COLUMN_MASK,
+                                                       BOARD_CENTER_COLUMN_MASK, BOARD_RIGHT_COLUMN_MASK,
+                                                       BOARD_LEFT_TO_RIGHT_DIAGONAL_MASK,
+                                                       BOARD_RIGHT_TO_LEFT_DIAGONAL_MASK };
+      auto res = std::array<std::array<std::uint32_t, 4>, 9>{ };
+      for (auto cell = std::size_t{ 0 }; cell < res.size(); ++cell)
+      {
+        auto count = std::size_t{ 0 };
+        for (const auto line : lines)
+        {
+          if (line & (ALL_CELL_BITS << (cell * 2)))
+          {
+            res[cell][count++] = line;
+          }
+        }
+        for (; count < res[cell].size(); ++count)
+        {
+          res[cell][count] = res[cell][0];
+        }
+      }
+      return res;
+    }();
+    auto pattern = std::uint32_t{ 0 };
+    switch (value)
+    {
+    case cell_contents::x:
+      pattern = COUNT_X_MASK;
+      break;
+    case cell_contents::o:
+      pattern = COUNT_O_MASK;
+      break;
+    default:
+      return false;
+    }
+    const auto shift = row * BOARD_MIDDLE_ROW_SHIFT + column * BOARD_CENTER_CELL_SHIFT;
+    const auto board = (m_data & ~(ALL_CELL_BITS << shift)) | (static_cast<std::uint32_t>(value) << shift);
+    auto res = false;
+    for (const auto line : CELL_LINES[row * 3 + column])
+    {
+      res = res || (board & line) == (pattern & line);
+    }
+    return res;
+  }
+
   bool state::is_cell_empty(const std::size_t column, const std::size_t row) const {
     return cell(column, row) == cell_contents::empty;
   }
@@ -174,6 +418,46 @@ namespace megatech::ttt::details {
     return std::popcount(m_data & COUNT_O_MASK);
   }
 
+  cell_set state::empty_cells() const {
+    // A cell is marked if either of its bits is set.
+    return cell_set{ ~compress_plane((m_data | (m_data >> 1)) & GAME_BOARD_MASK) };
+  }
+
+  cell_set state::x_cells() const {
+    return cell_set{ compress_plane(m_data & GAME_BOARD_MASK) };
+  }
+
+  cell_set state::o_cells() const {
+    return cell_set{ compress_plane((m_data >> 1) & GAME_BOARD_MASK) };
+  }
+
+  state state::transformed(const symmetry sym) const {
+    if (static_cast<std::size_t>(sym) >= SYMMETRY_COUNT)
+    {
+      throw std::runtime_error{ "The symmetry was invalid." };
+    }
+    const auto& table = SYMMETRY_TABLES[static_cast<std::size_t>(sym)];
+    auto res = *this;
+    res.m_data = (m_data & ~GAME_BOARD_MASK) | table[0][m_data & BOARD_UPPER_ROW_MASK] |
+                 table[1][(m_data & BOARD_MIDDLE_ROW_MASK) >> BOARD_MIDDLE_ROW_SHIFT] |
+                 table[2][(m_data & BOARD_BOTTOM_ROW_MASK) >> BOARD_BOTTOM_ROW_SHIFT];
+    res.rehash();
+    return res;
+  }
+
+  std::pair<state, symmetry> state::canonical() const {
+    auto res = std::pair<state, symmetry>{ *this, symmetry::identity };
+    for (auto sym = std::size_t{ 1 }; sym < SYMMETRY_COUNT; ++sym)
+    {
+      const auto next = transformed(static_cast<symmetry>(sym));
+      if (next.board() < res.first.board())
+      {
+        res = { next, static_cast<symmetry>(sym) };
+      }
+    }
+    return res;
+  }
+
   cell_contents state::cell(const std::size_t column, const std::size_t row) const {
     if (column > 2)
     {
@@ -183,14 +467,7 @@ namespace megatech::ttt::details {
     {
       throw std::runtime_error{ "The row index is out of bounds." };
     }
-    const auto row_masks = std::array<std::uint32_t, 3>{ BOARD_UPPER_ROW_MASK, BOARD_MIDDLE_ROW_MASK,
-                                                         BOARD_BOTTOM_ROW_MASK };
-    const auto row_shifts = std::array<std::size_t, 3>{ 0, BOARD_MIDDLE_ROW_SHIFT, BOARD_BOTTOM_ROW_SHIFT };
-    const auto cell_masks = std::array<std::uint32_t, 3>{ BOARD_LEFT_CELL_MASK, BOARD_CENTER_CELL_MASK,
-                                                          BOARD_RIGHT_CELL_MASK };
-    const auto cell_shifts = std::array<std::size_t, 3>{ 0, BOARD_CENTER_CELL_SHIFT, BOARD_RIGHT_CELL_SHIFT };
-    const auto entire_row = (m_data & row_masks[row]) >> row_shifts[row];
-    return static_cast<cell_contents>((entire_row & cell_masks[column]) >> cell_shifts[column]);
+    return unchecked_cell(column, row);
   }
 
   void state::cell(const std::size_t column, const std::size_t row, cell_contents value) {
@@ -202,11 +479,12 @@ namespace megatech::ttt::details {
     {
       throw std::runtime_error{ "The row index is out of bounds." };
     }
-    const auto row_shifts = std::array<std::size_t, 3>{ 0, BOARD_MIDDLE_ROW_SHIFT, BOARD_BOTTOM_ROW_SHIFT };
-    const auto cell_shifts = std::array<std::size_t, 3>{ 0, BOARD_CENTER_CELL_SHIFT, BOARD_RIGHT_CELL_SHIFT };
-    const auto clear_cell = ALL_CELL_BITS << (cell_shifts[column] + row_shifts[row]);
+    const auto shift = row * BOARD_MIDDLE_ROW_SHIFT + column * BOARD_CENTER_CELL_SHIFT;
+    const auto& keys = ZOBRIST_KEYS[row * 3 + column];
+    m_hash ^= keys[(m_data >> shift) & ALL_CELL_BITS] ^ keys[static_cast<std::uint32_t>(value) & ALL_CELL_BITS];
+    const auto clear_cell = ALL_CELL_BITS << shift;
     m_data &= ~clear_cell;
-    const auto value_bits = static_cast<std::uint32_t>(value) << (cell_shifts[column] + row_shifts[row]);
+    const auto value_bits = static_cast<std::uint32_t>(value) << shift;
     m_data |= value_bits;
   }
 }
@@ -0,0 +1,323 @@
+/**
+ * @file tablebase.cpp
+ * @brief Precomputed game theoretic values for every reachable position.
+ * @author Alexander Rothman <gnomesort@megate.ch>
+ * @date 2024
+ * @copyright AGPL-3.0+
+ */
+#include "megatech/ttt/details/tablebase.hpp"
+
+#include <cstring>
+
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+#include "megatech/ttt/details/bitboard.hpp"
+#include "megatech/ttt/details/data_file.hpp"
+#include "megatech/ttt/details/lockfile.hpp"
+#include "megatech/ttt/details/rank.hpp"
+#include "megatech/ttt/details/replace_file.hpp"
+
+namespace {
+
+  constexpr std::size_t CELLS{ megatech::ttt::details::state::COLUMNS * megatech::ttt::details::state::ROWS };
+
+  // With the distance encoding each entry is a 4-bit code. Losses always occur an even number of plies away and wins
+  // an odd number of plies away, so only half of the distances need codes. Draws always end with a full board so their
+  // distance follows from the board itself.
+  constexpr unsigned char DRAW_CODE{ 0 };
+  constexpr unsigned char LOSS_CODE{ 1 };
+  constexpr unsigned char WIN_CODE{ LOSS_CODE + CELLS / 2 + 1 };
+  constexpr unsigned char MAX_CODE{ WIN_CODE + (CELLS + 1) / 2 - 1 };
+
+  static_assert(MAX_CODE < 16, "The distance encoding requires every code to fit in 4 bits.");
+
+  // With the value encoding each entry is the 2-bit game_value.
+  constexpr unsigned char MAX_VALUE{ static_cast<unsigned char>(megatech::ttt::details::game_value::win) };
+
+  std::size_t entry_bits(const megatech::ttt::details::tablebase_encoding encoding) {
+    switch (encoding)
+    {
+    case megatech::ttt::details::tablebase_encoding::distance:
+      return 4;
+    case megatech::ttt::details::tablebase_encoding::value:
+      return 2;
+    default:
+      throw std::runtime_error{ "The tablebase encoding was invalid." };
+    }
+  }
+
+  std::size_t table_bytes(const megatech::ttt::details::tablebase_encoding encoding) {
+    const auto per_byte = 8 / entry_bits(encoding);
+    return (megatech::ttt::details::REACHABLE_BOARD_COUNT + per_byte - 1) / per_byte;
+  }
+
+  unsigned char encode(const megatech::ttt::details::tablebase_encoding encoding,
+                       const megatech::ttt::details::game_value value, const std::size_t distance) {
+    if (encoding == megatech::ttt::details::tablebase_encoding::value)
+    {
+      return static_cast<unsigned char>(value);
+    }
+    switch (value)
+    {
+    case megatech::ttt::details::game_value::loss:
+      return LOSS_CODE + distance / 2;
+    case megatech::ttt::details::game_value::win:
+      return WIN_CODE + distance / 2;
+    default:
+      return DRAW_CODE;
+    }
+  }
+
+  megatech::ttt::details::tablebase_entry decode(const megatech::ttt::details::tablebase_encoding encoding,
+                                                 const unsigned char code, const std::size_t filled) {
+    if (encoding == megatech::ttt::details::tablebase_encoding::value)
+    {
+      if (code > MAX_VALUE)
+      {
+        throw std::runtime_error{ "The tablebase is corrupt." };
+      }
+      const auto value = static_cast<megatech::ttt::details::game_value>(code);
+      if (value == megatech::ttt::details::game_value::draw)
+      {
+        return { value, CELLS - filled };
+      }
+      return { value, megatech::ttt::details::TABLEBASE_UNKNOWN_DISTANCE };
+    }
+    if (code > MAX_CODE)
+    {
+      throw std::runtime_error{ "The tablebase is corrupt." };
+    }
+    if (code >= WIN_CODE)
+    {
+      return { megatech::ttt::details::game_value::win, (code - WIN_CODE) * std::size_t{ 2 } + 1 };
+    }
+    if (code >= LOSS_CODE)
+    {
+      return { megatech::ttt::details::game_value::loss, (code - LOSS_CODE) * std::size_t{ 2 } };
+    }
+    return { megatech::ttt::details::game_value::draw, CELLS - filled };
+  }
+
+  void store(std::vector<unsigned char>& table, const std::size_t bits, const std::size_t index,
+             const unsigned char code) {
+    const auto per_byte = 8 / bits;
+    table[index / per_byte] |= code << ((index % per_byte) * bits);
+  }
+
+  unsigned char load(const unsigned char *const table, const std::size_t bits, const std::size_t index) {
+    const auto per_byte = 8 / bits;
+    return (table[index / per_byte] >> ((index % per_byte) * bits)) & ((1u << bits) - 1);
+  }
+
+  // Check a complete tablebase file and return a pointer to its table.
+  const unsigned char* validate(const unsigned char *const data, const std::size_t size,
+                                megatech::ttt::details::tablebase_encoding& encoding) {
+    if (size < sizeof(megatech::ttt::details::tablebase_header))
+    {
+      throw std::runtime_error{ "The requested tablebase file is too short to be valid." };
+    }
+    auto header = megatech::ttt::details::tablebase_header{ };
+    std::memcpy(&header, data, sizeof(megatech::ttt::details::tablebase_header));
+    if (std::memcmp(header.magic, megatech::ttt::details::TABLEBASE_HEADER_MAGIC,
+                    megatech::ttt::details::TABLEBASE_HEADER_MAGIC_LENGTH) != 0 ||
+        header.version != megatech::ttt::details::TABLEBASE_VERSION_1)
+    {
+      throw std::runtime_error{ "The tablebase file is corrupt." };
+    }
+    switch (header.endianness)
+    {
+    case megatech::ttt::details::DATA_FILE_REVERSE_ENDIANNESS:
+      header.positions = megatech::ttt::details::byte_swap(header.positions);
+      break;
+    case megatech::ttt::details::DATA_FILE_CORRECT_ENDIANNESS:
+      break;
+    default:
+      throw std::runtime_error{ "The tablebase file is corrupt or it was written with an unknown byte order." };
+    }
+    if (header.columns != megatech::ttt::details::state::COLUMNS ||
+        header.rows != megatech::ttt::details::state::ROWS ||
+        header.line_length != megatech::ttt::details::state::LINE_LENGTH ||
+        header.positions != megatech::ttt::details::REACHABLE_BOARD_COUNT)
+    {
+      throw std::runtime_error{ "The tablebase file was generated for a different game board." };
+    }
+    encoding = static_cast<megatech::ttt::details::tablebase_encoding>(header.encoding);
+    if (header.reserved[0] || header.reserved[1] || header.reserved[2] ||
+        (encoding != megatech::ttt::details::tablebase_encoding::distance &&
+         encoding != megatech::ttt::details::tablebase_encoding::value))
+    {
+      throw std::runtime_error{ "The tablebase file is corrupt." };
+    }
+    if (size < sizeof(megatech::ttt::details::tablebase_header) + table_bytes(encoding))
+    {
+      throw std::runtime_error{ "The tablebase file is truncated." };
+    }
+    return data + sizeof(megatech::ttt::details::tablebase_header);
+  }
+
+}
+
+namespace megatech::ttt::details {
+
+  std::vector<unsigned char> generate_tablebase(const tablebase_encoding encoding) {
+    const auto bits = entry_bits(encoding);
+    auto boards = std::vector<bitboard>{ };
+    boards.reserve(REACHABLE_BOARD_COUNT);
+    for (auto i = std::size_t{ 0 }; i < REACHABLE_BOARD_COUNT; ++i)
+    {
+      boards.emplace_back(unrank(i));
+    }
+    auto res = std::vector<unsigned char>(table_bytes(encoding));
+    auto resolved = std::vector<bool>(REACHABLE_BOARD_COUNT);
+    auto distances = std::vector<std::uint8_t>(REACHABLE_BOARD_COUNT);
+    auto values = std::vector<game_value>(REACHABLE_BOARD_COUNT, game_value::draw);
+    // The number of successors of each position that are not yet known to be won for the opponent.
+    auto remaining = std::vector<std::uint8_t>(REACHABLE_BOARD_COUNT);
+    // Positions are queued in the order they are resolved, which is also ascending order of distance. This ensures
+    // that wins take the shortest path and losses take the longest.
+    auto queue = std::vector<std::size_t>{ };
+    queue.reserve(REACHABLE_BOARD_COUNT);
+    const auto resolve = [&](const std::size_t index, const game_value value, const std::size_t distance) {
+      resolved[index] = true;
+      values[index] = value;
+      distances[index] = distance;
+      queue.push_back(index);
+    };
+    for (auto i = std::size_t{ 0 }; i < REACHABLE_BOARD_COUNT; ++i)
+    {
+      // A completed line always belongs to the player who just moved.
+      if (boards[i].winner() != cell_contents::empty)
+      {
+        resolve(i, game_value::loss, 0);
+      }
+      else if (boards[i].is_board_full())
+      {
+        // Finished draws are never queued because they can't resolve their predecessors.
+        resolved[i] = true;
+      }
+      else
+      {
+        remaining[i] = boards[i].empty_cells().size();
+      }
+    }
+    for (auto head = std::size_t{ 0 }; head < queue.size(); ++head)
+    {
+      const auto index = queue[head];
+      const auto& board = boards[index];
+      const auto last_player = board.player_to_move() == cell_contents::x ? cell_contents::o : cell_contents::x;
+      const auto last_cells = last_player == cell_contents::x ? board.x_cells() : board.o_cells();
+      for (const auto cell : last_cells)
+      {
+        auto previous = board;
+        previous.cell(cell, cell_contents::empty);
+        // The game would have ended before the last move was made.
+        if (previous.winner() != cell_contents::empty)
+        {
+          continue;
+        }
+        const auto previous_index = rank(static_cast<state>(previous));
+        if (resolved[previous_index])
+        {
+          continue;
+        }
+        if (values[index] == game_value::loss)
+        {
+          resolve(previous_index, game_value::win, distances[index] + 1);
+        }
+        else if (!--remaining[previous_index])
+        {
+          resolve(previous_index, game_value::loss, distances[index] + 1);
+        }
+      }
+    }
+    for (auto i = std::size_t{ 0 }; i < REACHABLE_BOARD_COUNT; ++i)
+    {
+      store(res, bits, i, encode(encoding, values[i], distances[i]));
+    }
+    return res;
+  }
+
+  void write_tablebase(const std::filesystem::path& path, const tablebase_encoding encoding) {
+    const auto table = generate_tablebase(encoding);
+    auto header = tablebase_header{ };
+    std::memcpy(header.magic, TABLEBASE_HEADER_MAGIC, TABLEBASE_HEADER_MAGIC_LENGTH);
+    header.version = TABLEBASE_VERSION_1;
+    header.columns = state::COLUMNS;
+    header.rows = state::ROWS;
+    header.line_length = state::LINE_LENGTH;
+    header.encoding = static_cast<unsigned char>(encoding);
+    header.endianness = DATA_FILE_CORRECT_ENDIANNESS;
+    header.positions = REACHABLE_BOARD_COUNT;
+    auto contents = std::vector<unsigned char>(sizeof(tablebase_header) + table.size());
+    std::memcpy(contents.data(), &header, sizeof(tablebase_header));
+    std::memcpy(contents.data() + sizeof(tablebase_header), table.data(), table.size());
+    // Like game data files, the old tablebase is only replaced once the new one is completely written.
+    auto lock = lockfile{ path };
+    lock.lock();
+    replace_file(std::filesystem::absolute(path), contents, sync_policy::data);
+  }
+
+  void tablebase::close() noexcept {
+    m_file.close();
+    m_table = nullptr;
+    m_buffer.clear();
+  }
+
+  tablebase::tablebase(const std::filesystem::path& path) {
+    if (mapped_file::is_available())
+    {
+      m_file = mapped_file{ path, false };
+      m_table = validate(m_file.data(), m_file.size(), m_encoding);
+      return;
+    }
+    auto f_in = std::ifstream{ path, std::ios::binary | std::ios::ate };
+    if (!f_in)
+    {
+      throw std::runtime_error{ "The tablebase file could not be opened." };
+    }
+    if (f_in.tellg() < 0)
+    {
+      throw std::runtime_error{ "The requested tablebase file is too short to be valid." };
+    }
+    m_buffer.resize(static_cast<std::size_t>(f_in.tellg()));
+    f_in.seekg(0, std::ios::beg);
+    f_in.read(reinterpret_cast<char*>(m_buffer.data()), m_buffer.size());
+    m_table = validate(m_buffer.data(), m_buffer.size(), m_encoding);
+  }
+
+  tablebase::tablebase(tablebase&& other) noexcept : m_table{ std::exchange(other.m_table, nullptr) },
+                                                     m_file{ std::move(other.m_file) },
+                                                     m_buffer{ std::move(other.m_buffer) },
+                                                     m_encoding{ other.m_encoding } { }
+
+  tablebase::~tablebase() noexcept {
+    close();
+  }
+
+  tablebase& tablebase::operator=(tablebase&& rhs) noexcept {
+    if (this != &rhs)
+    {
+      close();
+      m_table = std::exchange(rhs.m_table, nullptr);
+      m_file = std::move(rhs.m_file);
+      m_buffer = std::move(rhs.m_buffer);
+      m_encoding = rhs.m_encoding;
+    }
+    return *this;
+  }
+
+  tablebase_entry tablebase::probe(const state& st) const {
+    if (!m_table)
+    {
+      throw std::runtime_error{ "The tablebase is not open." };
+    }
+    return decode(m_encoding, load(m_table, entry_bits(m_encoding), rank(st)), st.filled_cells());
+  }
+
+  tablebase_encoding tablebase::encoding() const {
+    return m_encoding;
+  }
+
+}
@@ -0,0 +1,170 @@
+/**
+ * @file validation.cpp
+ * @brief Bulk validation of serialized game states.
+ * @author Alexander Rothman <gnomesort@megate.ch>
+ * @date 2024
+ * @copyright AGPL-3.0+
+ */
+#include "megatech/ttt/details/validation.hpp"
+
+#include <cstring>
+
+#include <array>
+#include <bit>
+#include <stdexcept>
+
+#include "megatech/ttt/details/state.hpp"
+
+// GCC and Clang can compile the AVX2 kernel for any x86 target and select it at runtime.
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+  #define MEGATECH_TTT_VALIDATION_AVX2 1
+  #include <immintrin.h>
+#endif
+#if defined(__SSE2__)
+  #include <emmintrin.h>
+#endif
+
+namespace {
+
+  using megatech::ttt::details::state;
+
+  // The low bit of each of the 9 cells. A cell is invalid when both of its bits are set.
+  constexpr std::uint32_t BOARD_LOW_BITS{ state::COUNT_X_MASK };
+
+#if defined(MEGATECH_TTT_VALIDATION_AVX2) || defined(__SSE2__)
+  // Convert an 8-bit mask of invalid states into 8 bool bytes. Byte i is 1 when bit i of the mask is clear. This
+  // assumes a little-endian target, which is always true on x86.
+  constexpr std::array<std::uint64_t, 256> VALID_BYTES = []() {
+    auto res = std::array<std::uint64_t, 256>{ };
+    for (auto mask = std::size_t{ 0 }; mask < res.size(); ++mask)
+    {
+      for (auto i = std::size_t{ 0 }; i < 8; ++i)
+      {
+        if (!(mask & (std::size_t{ 1 } << i)))
+        {
+          res[mask] |= std::uint64_t{ 1 } << (i * 8);
+        }
+      }
+    }
+    return res;
+  }();
+
+  void store_results(const unsigned int invalid_mask, bool *const results) {
+    static_assert(sizeof(bool) == 1, "Results must be stored as bytes.");
+    std::memcpy(results, &VALID_BYTES[invalid_mask], 8);
+  }
+
+  // Checks the first count states, 8 at a time, and returns the number of invalid states. count must be a multiple
+  // of 8.
+  using block_validator = std::size_t (*)(const std::uint32_t*, bool*, std::size_t);
+#endif
+
+#if defined(MEGATECH_TTT_VALIDATION_AVX2)
+  // Returns an 8-bit mask with a 1 for each invalid state.
+  __attribute__((target("avx2"))) unsigned int invalid_mask_avx2(const std::uint32_t *const states) {
+    const auto words = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(states));
+    const auto cells = _mm256_and_si256(_mm256_and_si256(words, _mm256_srli_epi32(words, 1)),
+                                        _mm256_set1_epi32(BOARD_LOW_BITS));
+    const auto unused = _mm256_and_si256(words, _mm256_set1_epi32(state::GAME_UNUSED_MASK));
+    const auto bad_bits = _mm256_or_si256(cells, unused);
+    const auto is_good = _mm256_cmpeq_epi32(bad_bits, _mm256_setzero_si256());
+    // The masked phase is always positive so a signed comparison is safe here.
+    const auto phase = _mm256_and_si256(words, _mm256_set1_epi32(state::GAME_PHASE_MASK));
+    const auto bad_phase = _mm256_cmpgt_epi32(phase, _mm256_set1_epi32(state::FIRST_INVALID_PHASE - 1));
+    const auto bad = _mm256_or_si256(_mm256_andnot_si256(is_good, _mm256_set1_epi32(-1)), bad_phase);
+    return static_cast<unsigned int>(_mm256_movemask_ps(_mm256_castsi256_ps(bad)));
+  }
+
+  __attribute__((target("avx2"))) std::size_t validate_blocks_avx2(const std::uint32_t *const states,
+                                                                   bool *const results, const std::size_t count) {
+    auto invalid = std::size_t{ 0 };
+    for (auto i = std::size_t{ 0 }; i < count; i += 8)
+    {
+      const auto mask = invalid_mask_avx2(states + i);
+      store_results(mask, results + i);
+      invalid += std::popcount(mask);
+    }
+    return invalid;
+  }
+#endif
+
+#if defined(__SSE2__)
+  // Returns a 4-bit mask with a 1 for each invalid state.
+  unsigned int invalid_mask_sse2(const std::uint32_t *const states) {
+    const auto words = _mm_loadu_si128(reinterpret_cast<const __m128i*>(states));
+    const auto cells = _mm_and_si128(_mm_and_si128(words, _mm_srli_epi32(words, 1)),
+                                     _mm_set1_epi32(BOARD_LOW_BITS));
+    const auto unused = _mm_and_si128(words, _mm_set1_epi32(state::GAME_UNUSED_MASK));
+    const auto bad_bits = _mm_or_si128(cells, unused);
+    const auto is_good = _mm_cmpeq_epi32(bad_bits, _mm_setzero_si128());
+    // The masked phase is always positive so a signed comparison is safe here.
+    const auto phase = _mm_and_si128(words, _mm_set1_epi32(state::GAME_PHASE_MASK));
+    const auto bad_phase = _mm_cmpgt_epi32(phase, _mm_set1_epi32(state::FIRST_INVALID_PHASE - 1));
+    const auto bad = _mm_or_si128(_mm_andnot_si128(is_good, _mm_set1_epi32(-1)), bad_phase);
+    return static_cast<unsigned int>(_mm_movemask_ps(_mm_castsi128_ps(bad)));
+  }
+
+  std::size_t validate_blocks_sse2(const std::uint32_t *const states, bool *const results, const std::size_t count) {
+    auto invalid = std::size_t{ 0 };
+    for (auto i = std::size_t{ 0 }; i < count; i += 8)
+    {
+      const auto mask = invalid_mask_sse2(states + i) | (invalid_mask_sse2(states + i + 4) << 4);
+      store_results(mask, results + i);
+      invalid += std::popcount(mask);
+    }
+    return invalid;
+  }
+#endif
+
+#if defined(MEGATECH_TTT_VALIDATION_AVX2) || defined(__SSE2__)
+  // Pick the widest kernel the running CPU supports. The result may be null when no vector kernel is available.
+  block_validator select_block_validator() {
+  #if defined(MEGATECH_TTT_VALIDATION_AVX2)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+      return validate_blocks_avx2;
+    }
+  #endif
+  #if defined(__SSE2__)
+    return validate_blocks_sse2;
+  #else
+    return nullptr;
+  #endif
+  }
+#endif
+
+}
+
+namespace megatech::ttt::details {
+
+  bool is_valid_state(const std::uint32_t data) noexcept {
+    const auto bad_bits = (data & (data >> 1) & BOARD_LOW_BITS) | (data & state::GAME_UNUSED_MASK);
+    return !bad_bits && (data & state::GAME_PHASE_MASK) < state::FIRST_INVALID_PHASE;
+  }
+
+  std::size_t validate_states(const std::span<const std::uint32_t> states, const std::span<bool> results) {
+    if (states.size() != results.size())
+    {
+      throw std::runtime_error{ "The state and result spans must be the same size." };
+    }
+    const auto count = states.size();
+    auto invalid = std::size_t{ 0 };
+    auto i = std::size_t{ 0 };
+#if defined(MEGATECH_TTT_VALIDATION_AVX2) || defined(__SSE2__)
+    static const auto validate_blocks = select_block_validator();
+    if (validate_blocks)
+    {
+      i = count - (count % 8);
+      invalid = validate_blocks(states.data(), results.data(), i);
+    }
+#endif
+    for (; i < count; ++i)
+    {
+      results[i] = is_valid_state(states[i]);
+      invalid += !results[i];
+    }
+    return invalid;
+  }
+
+}
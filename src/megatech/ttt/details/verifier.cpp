@@ -0,0 +1,270 @@
+/**
+ * @file verifier.cpp
+ * @brief Exhaustive verification of CPU player strategies.
+ * @author Alexander Rothman <gnomesort@megate.ch>
+ * @date 2024
+ * @copyright AGPL-3.0+
+ */
+#include "megatech/ttt/details/verifier.hpp"
+
+#include <cstddef>
+#include <cinttypes>
+
+#include <atomic>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {
+
+  // Positions with fewer marks than this are split into separate tasks. Deeper subtrees are small enough that
+  // searching them in place is cheaper than scheduling them.
+  constexpr std::size_t SPLIT_DEPTH{ 4 };
+
+  // A position where it is X's turn, along with X's previous move (which the heuristic strategy needs).
+  struct task final {
+    megatech::ttt::details::state st;
+    megatech::ttt::cell_location last;
+  };
+
+  // The owner pushes and pops at the back of its queue while idle workers steal from the front. This keeps each
+  // worker on the most recently split (and therefore smallest) subtrees while thieves take the largest ones.
+  class task_queue final {
+  private:
+    std::mutex m_mutex{ };
+    std::deque<task> m_tasks{ };
+  public:
+    void push(const task& t) {
+      auto lock = std::scoped_lock{ m_mutex };
+      m_tasks.push_back(t);
+    }
+
+    bool pop(task& t) {
+      auto lock = std::scoped_lock{ m_mutex };
+      if (m_tasks.empty())
+      {
+        return false;
+      }
+      t = m_tasks.back();
+      m_tasks.pop_back();
+      return true;
+    }
+
+    bool steal(task& t) {
+      auto lock = std::scoped_lock{ m_mutex };
+      if (m_tasks.empty())
+      {
+        return false;
+      }
+      t = m_tasks.front();
+      m_tasks.pop_front();
+      return true;
+    }
+  };
+
+  class pool final {
+  private:
+    std::vector<task_queue> m_queues;
+    // The number of tasks that have been pushed but not yet finished. Workers exit once this reaches 0.
+    std::atomic<std::size_t> m_pending{ };
+  public:
+    explicit pool(const std::size_t threads) : m_queues(threads) { }
+
+    void push(const std::size_t worker, const task& t) {
+      m_pending.fetch_add(1, std::memory_order_relaxed);
+      m_queues[worker].push(t);
+    }
+
+    bool next(const std::size_t worker, task& t) {
+      while (true)
+      {
+        if (m_queues[worker].pop(t))
+        {
+          return true;
+        }
+        for (auto i = std::size_t{ 1 }; i < m_queues.size(); ++i)
+        {
+          if (m_queues[(worker + i) % m_queues.size()].steal(t))
+          {
+            return true;
+          }
+        }
+        if (!m_pending.load(std::memory_order_acquire))
+        {
+          return false;
+        }
+        std::this_thread::yield();
+      }
+    }
+
+    void finish() {
+      m_pending.fetch_sub(1, std::memory_order_acq_rel);
+    }
+  };
+
+  class worker final {
+  private:
+    pool& m_pool;
+    std::size_t m_index;
+    megatech::ttt::strategy m_strategy;
+    megatech::ttt::details::verification_result m_result{ };
+
+    // Record a move and return true if it ended the game.
+    bool play(megatech::ttt::details::state& st, const megatech::ttt::cell_location& location,
+              const megatech::ttt::cell_contents mark) {
+      ++m_result.nodes;
+      const auto won = st.completes_line(location.column, location.row, mark);
+      st.cell(location.column, location.row, mark);
+      if (won)
+      {
+        ++m_result.games;
+        if (mark == megatech::ttt::cell_contents::x)
+        {
+          ++m_result.x_wins;
+          m_result.loss = st;
+        }
+        else
+        {
+          ++m_result.o_wins;
+        }
+        return true;
+      }
+      if (st.is_board_full())
+      {
+        ++m_result.games;
+        ++m_result.draws;
+        return true;
+      }
+      return false;
+    }
+
+    void search(const task& t) {
+      for (const auto index : t.st.empty_cells())
+      {
+        auto st = t.st;
+        const auto last = megatech::ttt::cell_location{ index % 3, index / 3 };
+        if (play(st, last, megatech::ttt::cell_contents::x))
+        {
+          continue;
+        }
+        // Follow every move the strategy could choose, not just the one it would draw at random.
+        const auto responses = m_strategy.candidates(st, last);
+        if (responses.empty())
+        {
+          throw std::runtime_error{ "The strategy failed to select a cell." };
+        }
+        for (const auto response : responses)
+        {
+          if (!st.is_cell_empty(response % 3, response / 3))
+          {
+            throw std::runtime_error{ "The strategy selected a cell that was not empty." };
+          }
+          auto next = st;
+          if (play(next, { response % 3, response / 3 }, megatech::ttt::cell_contents::o))
+          {
+            continue;
+          }
+          if (next.filled_cells() < SPLIT_DEPTH)
+          {
+            m_pool.push(m_index, { next, last });
+          }
+          else
+          {
+            search({ next, last });
+          }
+        }
+      }
+    }
+  public:
+    worker(pool& p, const std::size_t index, const megatech::ttt::strategy_algorithm algorithm,
+           const std::uint64_t seed) :
+    m_pool{ p }, m_index{ index }, m_strategy{ algorithm, seed + index } { }
+
+    void run() {
+      auto t = task{ };
+      while (m_pool.next(m_index, t))
+      {
+        // Tasks must be finished even if the search fails. Otherwise the remaining workers would never exit.
+        try
+        {
+          search(t);
+        }
+        catch (...)
+        {
+          m_pool.finish();
+          throw;
+        }
+        m_pool.finish();
+      }
+    }
+
+    const megatech::ttt::details::verification_result& result() const {
+      return m_result;
+    }
+  };
+
+}
+
+namespace megatech::ttt::details {
+
+  verification_result verify_strategy(const strategy_algorithm algorithm, const std::uint64_t seed,
+                                      const std::size_t threads) {
+    if (!threads)
+    {
+      throw std::runtime_error{ "At least one thread is required." };
+    }
+    auto p = pool{ threads };
+    auto workers = std::vector<worker>{ };
+    workers.reserve(threads);
+    for (auto i = std::size_t{ 0 }; i < threads; ++i)
+    {
+      workers.emplace_back(p, i, algorithm, seed);
+    }
+    auto errors = std::vector<std::exception_ptr>(threads);
+    auto res = verification_result{ };
+    // The empty board is the root of the tree.
+    ++res.nodes;
+    p.push(0, { state{ }, { 0, 0 } });
+    {
+      auto pool_threads = std::vector<std::jthread>{ };
+      for (auto i = std::size_t{ 0 }; i < threads; ++i)
+      {
+        pool_threads.emplace_back([&workers, &errors, i]() {
+          try
+          {
+            workers[i].run();
+          }
+          catch (...)
+          {
+            errors[i] = std::current_exception();
+          }
+        });
+      }
+    }
+    for (const auto& error : errors)
+    {
+      if (error)
+      {
+        std::rethrow_exception(error);
+      }
+    }
+    for (const auto& w : workers)
+    {
+      const auto& partial = w.result();
+      res.nodes += partial.nodes;
+      res.games += partial.games;
+      res.x_wins += partial.x_wins;
+      res.o_wins += partial.o_wins;
+      res.draws += partial.draws;
+      if (!res.loss)
+      {
+        res.loss = partial.loss;
+      }
+    }
+    return res;
+  }
+
+}
@@ -7,144 +7,242 @@
  */
 #include "megatech/ttt/game.hpp"
 
+#include <cstddef>
 #include <cstring>
-#include <cassert>
 
+#include <algorithm>
+#include <atomic>
 #include <bit>
 #include <stdexcept>
 #include <fstream>
+#include <string>
+#include <vector>
 
 #include "megatech/ttt/details/data_file.hpp"
-
-#define BSWAP32(x) \
-  ((((x) & 0x00'00'00'ff) << 24) | \
-    (((x) & 0x00'00'ff'00) << 8) | \
-    (((x) & 0x00'ff'00'00) >> 8) | \
-    (((x) & 0xff'00'00'00) >> 24))
+#include "megatech/ttt/details/replace_file.hpp"
+#include "megatech/ttt/details/rules.hpp"
 
 namespace megatech::ttt {
 
-  void game::read_data_file() {
-    auto f_in = std::ifstream{ m_path, std::ios::binary | std::ios::ate };
-    if (f_in.tellg() < 0 || static_cast<std::size_t>(f_in.tellg()) < sizeof(details::data_file_header))
+  std::uint32_t game::normalize(const std::uint32_t value) const {
+    return m_reversed ? details::byte_swap(value) : value;
+  }
+
+  std::size_t game::locate_record(const unsigned char* data, const std::size_t size, const std::uintmax_t file_size) {
+    if (size < sizeof(details::data_file_header))
     {
       throw std::runtime_error{ "The requested game data file is too short to be valid." };
     }
-    f_in.seekg(0, std::ios::beg);
-    auto header = details::data_file_header{ };
-    f_in.read(reinterpret_cast<char*>(&header), sizeof(details::data_file_header));
-    if (std::memcmp(header.magic, details::DATA_FILE_HEADER_MAGIC, details::DATA_FILE_HEADER_MAGIC_LENGTH) != 0 ||
-        header.version != details::DATA_FILE_VERSION_1)
+    // The header is only made of bytes so it can be checked where it is.
+    const auto header = reinterpret_cast<const details::data_file_header*>(data);
+    if (std::memcmp(header->magic, details::DATA_FILE_HEADER_MAGIC, details::DATA_FILE_HEADER_MAGIC_LENGTH) != 0)
     {
       throw std::runtime_error{ "The game data file is corrupt." };
     }
-    auto body = details::data_file_body_v1{ };
-    f_in.read(reinterpret_cast<char*>(&body), sizeof(details::data_file_body_v1));
-    switch (body.endianness)
+    auto endianness = std::uint32_t{ };
+    auto res = std::size_t{ };
+    switch (m_version = header->version; m_version)
+    {
+    case details::DATA_FILE_VERSION_1:
+      if (m_id)
+      {
+        throw std::runtime_error{ "The requested game does not exist in the game data file." };
+      }
+      if (size < sizeof(details::data_file_header) + sizeof(details::data_file_body_v1))
+      {
+        throw std::runtime_error{ "The requested game data file is too short to be valid." };
+      }
+      std::memcpy(&endianness, data + sizeof(details::data_file_header), sizeof(std::uint32_t));
+      res = sizeof(details::data_file_header);
+      break;
+    case details::DATA_FILE_VERSION_2:
+    {
+      if (size < details::DATA_FILE_RECORDS_V2_OFFSET)
+      {
+        throw std::runtime_error{ "The requested game data file is too short to be valid." };
+      }
+      if (!details::is_data_file_v2_padding_valid(data))
+      {
+        throw std::runtime_error{ "The game data file is corrupt." };
+      }
+      auto body = details::data_file_body_v2{ };
+      std::memcpy(&body, data + details::DATA_FILE_BODY_V2_OFFSET, sizeof(details::data_file_body_v2));
+      endianness = body.endianness;
+      const auto count = endianness == details::DATA_FILE_REVERSE_ENDIANNESS ? details::byte_swap(body.count) :
+                                                                               body.count;
+      if (m_id >= count)
+      {
+        throw std::runtime_error{ "The requested game does not exist in the game data file." };
+      }
+      res = details::data_file_record_v2_offset(m_id);
+      if (file_size < details::data_file_record_v2_offset(count))
+      {
+        throw std::runtime_error{ "The requested game data file is too short to be valid." };
+      }
+      break;
+    }
+    default:
+      throw std::runtime_error{ "The game data file is corrupt." };
+    }
+    switch (endianness)
     {
     case details::DATA_FILE_REVERSE_ENDIANNESS:
-      m_state = details::state{ BSWAP32(body.state) };
+      m_reversed = true;
+      // Files are always written in the system byte order so this one needs to be rewritten even if play doesn't
+      // change the state.
+      m_dirty = true;
       break;
     case details::DATA_FILE_CORRECT_ENDIANNESS:
-      m_state = details::state{ body.state };
+      m_reversed = false;
       break;
     default:
       throw std::runtime_error{ "The game data file is corrupt or it was written with an unknown byte order." };
     }
+    return res;
   }
 
-
-  cell_contents game::find_winner() const {
-    for (auto i = 0; i < 3; ++i)
+  void game::load_record(const unsigned char* record) {
+    // Version 1 bodies and version 2 records are both two 32-bit words with the state second.
+    auto first = std::uint32_t{ };
+    auto state = std::uint32_t{ };
+    std::memcpy(&first, record, sizeof(std::uint32_t));
+    std::memcpy(&state, record + sizeof(std::uint32_t), sizeof(std::uint32_t));
+    if (m_version == details::DATA_FILE_VERSION_2 && normalize(first) != m_id)
     {
-      if (m_state.is_row_x(i))
+      throw std::runtime_error{ "The game data file is corrupt." };
+    }
+    m_state = details::state{ normalize(state) };
+  }
+
+  void game::read_data_file() {
+    static_assert(sizeof(details::data_file_body_v1) == sizeof(details::data_file_record_v2));
+    static_assert(offsetof(details::data_file_body_v1, state) == offsetof(details::data_file_record_v2, state));
+    if (details::mapped_file::is_available())
     {
-        return cell_contents::x;
-      }
-      if (m_state.is_row_o(i))
+      m_file = details::mapped_file{ m_path, m_open_mode == open_mode::read_write };
+      m_record_offset = locate_record(m_file.data(), m_file.size(), m_file.size());
+      load_record(m_file.data() + m_record_offset);
+      // Only version 2 files that are already in the system byte order can be updated in place. Their states are
+      // aligned so they can be stored atomically. Read-only games never update their file so they're done with it.
+      if (m_open_mode == open_mode::read_only || m_reversed || m_version != details::DATA_FILE_VERSION_2)
       {
-        return cell_contents::o;
+        m_file.close();
       }
+      return;
+    }
+    // Only the fixed size part of the file and the requested record are read no matter how many games there are.
+    auto f_in = std::ifstream{ m_path, std::ios::binary | std::ios::ate };
+    const auto file_size = static_cast<std::uintmax_t>(std::max(f_in.tellg(), std::streampos{ 0 }));
+    f_in.seekg(0, std::ios::beg);
+    unsigned char buffer[details::DATA_FILE_RECORDS_V2_OFFSET]{ };
+    f_in.read(reinterpret_cast<char*>(buffer), sizeof(buffer));
+    m_record_offset = locate_record(buffer, static_cast<std::size_t>(f_in.gcount()), file_size);
+    f_in.clear();
+    f_in.seekg(static_cast<std::streamoff>(m_record_offset), std::ios::beg);
+    unsigned char record[sizeof(details::data_file_record_v2)]{ };
+    if (!f_in.read(reinterpret_cast<char*>(record), sizeof(record)))
+    {
+      throw std::runtime_error{ "The requested game data file is too short to be valid." };
+    }
+    load_record(record);
+  }
+
+  void game::update_data_file() {
+    // Only version 2 files stay mapped. Their state fields are aligned so other processes that map the file see
+    // either the old state or the new state.
+    auto state = reinterpret_cast<std::uint32_t*>(m_file.data() + m_record_offset +
+                                                  offsetof(details::data_file_record_v2, state));
+    std::atomic_ref<std::uint32_t>{ *state }.store(static_cast<std::uint32_t>(m_state), std::memory_order_release);
+    switch (m_sync_policy)
+    {
+    case sync_policy::data:
+      m_file.flush(false);
+      break;
+    case sync_policy::full:
+      m_file.flush(true);
+      break;
+    default:
+      break;
     }
-    for (auto i = 0; i < 3; ++i)
+  }
+
+  void game::write_data_file() const {
+    auto contents = std::vector<unsigned char>{ };
+    if (m_version == details::DATA_FILE_VERSION_2)
     {
-      if (m_state.is_column_x(i))
+      // The other games have to be carried over. Every value is rewritten in the system byte order.
+      auto f_in = std::ifstream{ m_path, std::ios::binary | std::ios::ate };
+      contents.resize(static_cast<std::size_t>(std::max(f_in.tellg(), std::streampos{ 0 })));
+      f_in.seekg(0, std::ios::beg);
+      f_in.read(reinterpret_cast<char*>(contents.data()), static_cast<std::streamsize>(contents.size()));
+      if (!f_in || contents.size() < details::data_file_record_v2_offset(m_id + 1))
       {
-        return cell_contents::x;
+        throw std::runtime_error{ "The game data file could not be read back." };
       }
-      if (m_state.is_column_o(i))
+      if (m_reversed)
       {
-        return cell_contents::o;
+        for (auto i = details::DATA_FILE_BODY_V2_OFFSET; i + sizeof(std::uint32_t) <= contents.size();
+             i += sizeof(std::uint32_t))
+        {
+          auto value = std::uint32_t{ };
+          std::memcpy(&value, contents.data() + i, sizeof(std::uint32_t));
+          value = details::byte_swap(value);
+          std::memcpy(contents.data() + i, &value, sizeof(std::uint32_t));
+        }
       }
     }
-    if (m_state.is_left_diagonal_x() || m_state.is_right_diagonal_x())
-    {
-      return cell_contents::x;
-    }
-    if (m_state.is_left_diagonal_o() || m_state.is_right_diagonal_o())
+    else
     {
-      return cell_contents::o;
+      auto header = details::data_file_header{ };
+      std::memcpy(header.magic, details::DATA_FILE_HEADER_MAGIC, details::DATA_FILE_HEADER_MAGIC_LENGTH);
+      header.version = details::DATA_FILE_VERSION_1;
+      auto body = details::data_file_body_v1{ };
+      body.endianness = details::DATA_FILE_CORRECT_ENDIANNESS;
+      contents.resize(sizeof(details::data_file_header) + sizeof(details::data_file_body_v1));
+      std::memcpy(contents.data(), &header, sizeof(details::data_file_header));
+      std::memcpy(contents.data() + sizeof(details::data_file_header), &body, sizeof(details::data_file_body_v1));
     }
-    return cell_contents::empty;
+    const auto value = static_cast<std::uint32_t>(m_state);
+    std::memcpy(contents.data() + m_record_offset + offsetof(details::data_file_record_v2, state), &value,
+                sizeof(std::uint32_t));
+    details::replace_file(m_path, contents, m_sync_policy);
   }
 
-  void game::update_play_state() {
-    switch (find_winner())
+  void game::check_data_file() const {
+    auto stat = std::filesystem::status(m_path);
+    if (!std::filesystem::status_known(stat))
     {
-    case cell_contents::x:
-      m_state.phase(game_phase::win_x);
-      return;
-    case cell_contents::o:
-      m_state.phase(game_phase::win_o);
-      return;
-    default:
-      break;
+      throw std::runtime_error{ "The status of the game data file could not be determined." };
     }
-    if (m_state.is_board_full())
+    if (!std::filesystem::exists(stat))
     {
-      m_state.phase(game_phase::draw);
-      return;
+      throw std::runtime_error{ "The requested game data file does not exist." };
     }
-    switch (m_state.phase())
+    if (!std::filesystem::is_regular_file(stat))
     {
-    case game_phase::turn_x:
-      m_state.phase(game_phase::turn_o);
-      return;
-    case game_phase::turn_o:
-      m_state.phase(game_phase::turn_x);
-      return;
-    default:
-      // Unless something is really broken this can't happen.
-      assert(((void) "Unreachable", false));
+      throw std::runtime_error{ "The requested game data file is not a regular file." };
     }
   }
 
-  void game::take_turn(const std::size_t column, const std::size_t row, const cell_contents value) {
-    if (m_state.cell(column, row) != cell_contents::empty)
+  game::game(const std::filesystem::path& path) : game{ path, open_mode::read_write } { }
+
+  game::game(const std::filesystem::path& path, const open_mode access) : game{ path, 0, access } { }
+
+  game::game(const std::filesystem::path& path, const game_mode mode) : game{ path, 0, mode } { }
+
+  game::game(const std::filesystem::path& path, const std::uint32_t id, const open_mode access) :
+  m_path{ std::filesystem::absolute(path) }, m_lock{ m_path }, m_id{ id }, m_open_mode{ access } {
+    // Read-only games never write so there is nothing for the lock to protect.
+    if (m_open_mode == open_mode::read_only)
     {
-      throw std::runtime_error{ "The desired turn was invalid because the cell was already filled." };
+      check_data_file();
+      read_data_file();
+      return;
     }
-    m_state.cell(column, row, value);
-    update_play_state();
-  }
-
-  game::game(const std::filesystem::path& path) : m_path{ std::filesystem::absolute(path) }, m_lock{ m_path } {
     try
     {
       m_lock.lock();
-      auto stat = std::filesystem::status(m_path);
-      if (!std::filesystem::status_known(stat))
-      {
-        throw std::runtime_error{ "The status of the game data file could not be determined." };
-      }
-      if (!std::filesystem::exists(stat))
-      {
-        throw std::runtime_error{ "The requested game data file does not exist." };
-      }
-      if (!std::filesystem::is_regular_file(stat))
-      {
-        throw std::runtime_error{ "The requested game data file is not a regular file." };
-      }
+      check_data_file();
       read_data_file();
     }
     catch (...)
@@ -154,8 +252,8 @@ namespace megatech::ttt {
     }
   }
 
-  game::game(const std::filesystem::path& path, const game_mode mode) : m_path{ std::filesystem::absolute(path) },
-                                                                        m_lock{ m_path } {
+  game::game(const std::filesystem::path& path, const std::uint32_t id, const game_mode mode) :
+  m_path{ std::filesystem::absolute(path) }, m_lock{ m_path }, m_id{ id } {
     try
     {
       m_lock.lock();
@@ -172,7 +270,13 @@ namespace megatech::ttt {
         }
         read_data_file();
       }
+      else if (m_id)
+      {
+        // New files only ever hold a single game.
+        throw std::runtime_error{ "The requested game does not exist in the game data file." };
+      }
       m_state = details::state{ 0 | static_cast<std::uint32_t>(mode) };
+      m_dirty = true;
     }
     catch (...)
     {
@@ -182,31 +286,43 @@ namespace megatech::ttt {
   }
 
   game::~game() noexcept {
+    // Unchanged games are never rewritten. Errors can't be reported from here so a failed write leaves the previous
+    // file in place.
+    if (m_open_mode == open_mode::read_write && m_dirty)
     {
-      auto f_out = std::ofstream{ m_path, std::ios::binary | std::ios::trunc };
-      auto header = details::data_file_header{ };
-      std::memcpy(header.magic, details::DATA_FILE_HEADER_MAGIC, details::DATA_FILE_HEADER_MAGIC_LENGTH);
-      header.version = details::DATA_FILE_VERSION_1;
-      f_out.write(reinterpret_cast<char*>(&header), sizeof(details::data_file_header));
-      auto body = details::data_file_body_v1{ };
-      body.endianness = details::DATA_FILE_CORRECT_ENDIANNESS;
-      body.state = static_cast<std::uint32_t>(m_state);
-      f_out.write(reinterpret_cast<char*>(&body), sizeof(details::data_file_body_v1));
+      try
+      {
+        if (m_file.is_open())
+        {
+          update_data_file();
+        }
+        else
+        {
+          write_data_file();
+        }
+      }
+      catch (...) { }
     }
+    m_file.close();
     m_lock.unlock();
   }
 
+  sync_policy game::synchronization() const {
+    return m_sync_policy;
+  }
+
+  void game::synchronization(const sync_policy policy) {
+    m_sync_policy = policy;
+  }
+
   void game::take_turn(const std::size_t column, const std::size_t row) {
-    switch (m_state.phase())
+    if (m_open_mode == open_mode::read_only)
     {
-    case game_phase::turn_x:
-      take_turn(column, row, cell_contents::x);
-      break;
-    case game_phase::turn_o:
-      take_turn(column, row, cell_contents::o);
-      break;
-    default:
-      break;
+      throw std::runtime_error{ "The game was opened read-only." };
+    }
+    if (details::take_turn(m_state, column, row))
+    {
+      m_dirty = true;
     }
   }
 
@@ -214,4 +330,31 @@ namespace megatech::ttt {
     return m_state;
   }
 
+  std::uint32_t game::id() const {
+    return m_id;
+  }
+
+  void create_game_table(const std::filesystem::path& path, const std::uint32_t count, const game_mode mode,
+                         const sync_policy policy) {
+    auto lock = details::lockfile{ path };
+    lock.lock();
+    auto header = details::data_file_header{ };
+    std::memcpy(header.magic, details::DATA_FILE_HEADER_MAGIC, details::DATA_FILE_HEADER_MAGIC_LENGTH);
+    header.version = details::DATA_FILE_VERSION_2;
+    auto body = details::data_file_body_v2{ };
+    body.endianness = details::DATA_FILE_CORRECT_ENDIANNESS;
+    body.count = count;
+    // The padding between the header and the body is zeroed here.
+    auto contents = std::vector<unsigned char>(details::data_file_record_v2_offset(count));
+    std::memcpy(contents.data(), &header, sizeof(details::data_file_header));
+    std::memcpy(contents.data() + details::DATA_FILE_BODY_V2_OFFSET, &body, sizeof(details::data_file_body_v2));
+    for (auto id = std::uint32_t{ 0 }; id < count; ++id)
+    {
+      const auto record = details::data_file_record_v2{ id, static_cast<std::uint32_t>(mode) };
+      std::memcpy(contents.data() + details::data_file_record_v2_offset(id), &record,
+                  sizeof(details::data_file_record_v2));
+    }
+    details::replace_file(std::filesystem::absolute(path), contents, policy);
+  }
+
 }
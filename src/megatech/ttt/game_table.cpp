@@ -0,0 +1,198 @@
+/**
+ * @file game_table.cpp
+ * @brief Lock-free shared access to many games of Tic-Tac-Toe.
+ * @author Alexander Rothman <gnomesort@megate.ch>
+ * @date 2024
+ * @copyright AGPL-3.0+
+ */
+#include "megatech/ttt/game_table.hpp"
+
+#include <cstddef>
+#include <cstring>
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "megatech/ttt/details/data_file.hpp"
+#include "megatech/ttt/details/lockfile.hpp"
+#include "megatech/ttt/details/replace_file.hpp"
+#include "megatech/ttt/details/rules.hpp"
+
+// Other processes can only see atomic operations on the mapping if they don't depend on a lock inside this process.
+static_assert(std::atomic_ref<std::uint32_t>::is_always_lock_free);
+static_assert((megatech::ttt::details::DATA_FILE_RECORDS_V2_OFFSET +
+               offsetof(megatech::ttt::details::data_file_record_v2, state)) %
+              std::atomic_ref<std::uint32_t>::required_alignment == 0);
+static_assert(sizeof(megatech::ttt::details::data_file_record_v2) %
+              std::atomic_ref<std::uint32_t>::required_alignment == 0);
+
+namespace {
+
+  // Tables are always shared in the system byte order so reversed files are rewritten before they're mapped. Every
+  // value after the header is a 32-bit word.
+  void normalize_byte_order(const std::filesystem::path& path) {
+    auto lock = megatech::ttt::details::lockfile{ path };
+    lock.lock();
+    auto f_in = std::ifstream{ path, std::ios::binary | std::ios::ate };
+    auto contents = std::vector<unsigned char>(static_cast<std::size_t>(std::max(f_in.tellg(), std::streampos{ 0 })));
+    f_in.seekg(0, std::ios::beg);
+    f_in.read(reinterpret_cast<char*>(contents.data()), static_cast<std::streamsize>(contents.size()));
+    if (!f_in || contents.size() < megatech::ttt::details::DATA_FILE_RECORDS_V2_OFFSET)
+    {
+      throw std::runtime_error{ "The game data file could not be read back." };
+    }
+    // Another process may have rewritten the file before the lock was taken.
+    auto endianness = std::uint32_t{ };
+    std::memcpy(&endianness, contents.data() + megatech::ttt::details::DATA_FILE_BODY_V2_OFFSET,
+                sizeof(std::uint32_t));
+    if (endianness != megatech::ttt::details::DATA_FILE_REVERSE_ENDIANNESS)
+    {
+      return;
+    }
+    for (auto i = megatech::ttt::details::DATA_FILE_BODY_V2_OFFSET; i + sizeof(std::uint32_t) <= contents.size();
+         i += sizeof(std::uint32_t))
+    {
+      auto value = std::uint32_t{ };
+      std::memcpy(&value, contents.data() + i, sizeof(std::uint32_t));
+      value = megatech::ttt::details::byte_swap(value);
+      std::memcpy(contents.data() + i, &value, sizeof(std::uint32_t));
+    }
+    megatech::ttt::details::replace_file(std::filesystem::absolute(path), contents,
+                                         megatech::ttt::sync_policy::none);
+  }
+
+}
+
+namespace megatech::ttt {
+
+  game_table::game_table(const std::filesystem::path& path) {
+    auto file = details::mapped_file{ path, true };
+    if (file.size() < details::DATA_FILE_RECORDS_V2_OFFSET)
+    {
+      throw std::runtime_error{ "The requested game data file is too short to be valid." };
+    }
+    const auto header = reinterpret_cast<const details::data_file_header*>(file.data());
+    if (std::memcmp(header->magic, details::DATA_FILE_HEADER_MAGIC, details::DATA_FILE_HEADER_MAGIC_LENGTH) != 0)
+    {
+      throw std::runtime_error{ "The game data file is corrupt." };
+    }
+    if (header->version != details::DATA_FILE_VERSION_2)
+    {
+      throw std::runtime_error{ "The game data file does not hold many games." };
+    }
+    if (!details::is_data_file_v2_padding_valid(file.data()))
+    {
+      throw std::runtime_error{ "The game data file is corrupt." };
+    }
+    auto body = details::data_file_body_v2{ };
+    std::memcpy(&body, file.data() + details::DATA_FILE_BODY_V2_OFFSET, sizeof(details::data_file_body_v2));
+    switch (body.endianness)
+    {
+    case details::DATA_FILE_REVERSE_ENDIANNESS:
+    {
+      file.close();
+      normalize_byte_order(path);
+      file = details::mapped_file{ path, true };
+      if (file.size() < details::DATA_FILE_RECORDS_V2_OFFSET)
+      {
+        throw std::runtime_error{ "The requested game data file is too short to be valid." };
+      }
+      std::memcpy(&body, file.data() + details::DATA_FILE_BODY_V2_OFFSET, sizeof(details::data_file_body_v2));
+      if (body.endianness != details::DATA_FILE_CORRECT_ENDIANNESS)
+      {
+        throw std::runtime_error{ "The game data file could not be rewritten in the system byte order." };
+      }
+      break;
+    }
+    case details::DATA_FILE_CORRECT_ENDIANNESS:
+      break;
+    default:
+      throw std::runtime_error{ "The game data file is corrupt or it was written with an unknown byte order." };
+    }
+    if (file.size() < details::data_file_record_v2_offset(body.count))
+    {
+      throw std::runtime_error{ "The requested game data file is too short to be valid." };
+    }
+    m_file = std::move(file);
+    m_size = body.count;
+  }
+
+  std::uint32_t& game_table::slot(const std::uint32_t id) const {
+    if (id >= m_size)
+    {
+      throw std::runtime_error{ "The requested game does not exist in the game table." };
+    }
+    // Only states are ever written through the table so IDs can be read normally.
+    const auto record = const_cast<unsigned char*>(m_file.data()) + details::data_file_record_v2_offset(id);
+    auto stored_id = std::uint32_t{ };
+    std::memcpy(&stored_id, record, sizeof(std::uint32_t));
+    if (stored_id != id)
+    {
+      throw std::runtime_error{ "The game data file is corrupt." };
+    }
+    return *reinterpret_cast<std::uint32_t*>(record + offsetof(details::data_file_record_v2, state));
+  }
+
+  std::uint32_t game_table::size() const {
+    return m_size;
+  }
+
+  details::state game_table::state(const std::uint32_t id) const {
+    return details::state{ std::atomic_ref<std::uint32_t>{ slot(id) }.load(std::memory_order_acquire) };
+  }
+
+  bool game_table::take_turn(const std::uint32_t id, const cell_contents player, const std::size_t column,
+                             const std::size_t row) {
+    auto turn = game_phase::turn_x;
+    switch (player)
+    {
+    case cell_contents::x:
+      break;
+    case cell_contents::o:
+      turn = game_phase::turn_o;
+      break;
+    default:
+      throw std::runtime_error{ "The player was invalid." };
+    }
+    auto current = std::atomic_ref<std::uint32_t>{ slot(id) };
+    auto expected = current.load(std::memory_order_acquire);
+    while (true)
+    {
+      auto next = details::state{ expected };
+      // On failure expected is updated to the latest state. If another turn was taken in the meantime, it is now the
+      // other player's turn and this turn must not be reapplied for them.
+      if (next.phase() != turn || !details::take_turn(next, column, row))
+      {
+        return false;
+      }
+      if (current.compare_exchange_weak(expected, static_cast<std::uint32_t>(next), std::memory_order_acq_rel,
+                                        std::memory_order_acquire))
+      {
+        return true;
+      }
+    }
+  }
+
+  void game_table::reset(const std::uint32_t id, const game_mode mode) {
+    std::atomic_ref<std::uint32_t>{ slot(id) }.store(static_cast<std::uint32_t>(mode), std::memory_order_release);
+  }
+
+  void game_table::flush(const sync_policy policy) {
+    switch (policy)
+    {
+    case sync_policy::data:
+      m_file.flush(false);
+      break;
+    case sync_policy::full:
+      m_file.flush(true);
+      break;
+    default:
+      break;
+    }
+  }
+
+}
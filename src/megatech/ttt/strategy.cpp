@@ -7,9 +7,14 @@
  */
 #include "megatech/ttt/strategy.hpp"
 
+#include <chrono>
 #include <stdexcept>
+#include <iterator>
+#include <memory>
 
 #include "megatech/ttt/game.hpp"
+#include "megatech/ttt/details/book.hpp"
+#include "megatech/ttt/details/forks.hpp"
 
 namespace {
 
@@ -17,266 +22,248 @@ namespace {
     return location.column < 3 && location.row < 3;
   }
 
+  megatech::ttt::cell_location to_location(const std::size_t index) {
+    return { index % 3, index / 3 };
+  }
+
+  megatech::ttt::details::cell_set to_cells(const megatech::ttt::cell_location& location) {
+    return megatech::ttt::details::cell_set{ std::uint32_t{ 1 } << (location.row * 3 + location.column) };
+  }
+
+  // Seeds only need to differ between runs. Reading the clock avoids the system call made by std::random_device.
+  std::uint64_t time_seed() {
+    return static_cast<std::uint64_t>(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+  }
+
 }
 
 namespace megatech::ttt {
 
-  cell_location strategy::find_edge(const details::state& st) const {
-    // Edge cells are neither a corner nor the center cell.
-    auto available = std::vector<cell_location>{ };
-    if (st.is_cell_empty(1, 0))
-    {
-      available.push_back({ 1, 0 });
-    }
-    if (st.is_cell_empty(0, 1))
-    {
-      available.push_back({ 0, 1 });
-    }
-    if (st.is_cell_empty(1, 2))
-    {
-      available.push_back({ 1, 2 });
-    }
-    if (st.is_cell_empty(2, 1))
-    {
-      available.push_back({ 2, 1 });
-    }
-    if (available.empty())
+  cell_location strategy::select(const details::cell_set cells) const {
+    switch (cells.size())
     {
+    case 0:
       return INVALID_LOCATION;
+    case 1:
+      return to_location(*cells.begin());
+    default:
+      {
+        const auto offset = static_cast<std::ptrdiff_t>(m_prng.below(cells.size()));
+        return to_location(*std::ranges::next(cells.begin(), offset));
+      }
     }
-    auto selector = std::uniform_int_distribution<std::size_t>{ 0, available.size() - 1 };
-    return available[selector(m_prng)];
   }
 
-  cell_location strategy::find_corner(const details::state& st) const {
-    auto available = std::vector<cell_location>{ };
-    if (st.is_cell_empty(0, 0))
-    {
-      available.push_back({ 0, 0 });
-    }
-    if (st.is_cell_empty(0, 2))
-    {
-      available.push_back({ 0, 2 });
-    }
-    if (st.is_cell_empty(2, 2))
-    {
-      available.push_back({ 2, 2 });
-    }
-    if (st.is_cell_empty(2, 0))
-    {
-      available.push_back({ 2, 0 });
-    }
-    if (available.empty())
-    {
-      return INVALID_LOCATION;
-    }
-    auto selector = std::uniform_int_distribution<std::size_t>{ 0, available.size() - 1 };
-    return available[selector(m_prng)];
+  details::cell_set strategy::find_edges(const details::state& st) const {
+    // Edge cells are neither a corner nor the center cell.
+    return details::cell_set{ static_cast<std::uint32_t>(st.empty_cells()) & EDGE_CELLS };
+  }
+
+  details::cell_set strategy::find_corners(const details::state& st) const {
+    return details::cell_set{ static_cast<std::uint32_t>(st.empty_cells()) & CORNER_CELLS };
   }
 
   cell_location strategy::find_opposite_corner(const details::state& st, const cell_location& last) const {
-    if (last.column == 0 && last.row == 0 && st.is_cell_empty(2, 2))
+    if (last.column == 0 && last.row == 0 && st.cell<2, 2>() == cell_contents::empty)
     {
       return { 2, 2 };
     }
-    if (last.column == 0 && last.row == 2 && st.is_cell_empty(2, 0))
+    if (last.column == 0 && last.row == 2 && st.cell<2, 0>() == cell_contents::empty)
     {
       return { 2, 0 };
     }
-    if (last.column == 2 && last.row == 2 && st.is_cell_empty(0, 0))
+    if (last.column == 2 && last.row == 2 && st.cell<0, 0>() == cell_contents::empty)
     {
       return { 0, 0 };
     }
-    if (last.column == 2 && last.row == 0 && st.is_cell_empty(0, 2))
+    if (last.column == 2 && last.row == 0 && st.cell<0, 2>() == cell_contents::empty)
     {
       return { 0, 2 };
     }
     return INVALID_LOCATION;
   }
 
-  std::vector<cell_location> strategy::find_empty_locations(const details::state& st) const {
-    if (st.is_board_empty())
-    {
-      // This is every cell.
-      return { { 0, 0 }, { 1, 0 }, { 2, 0 }, { 0, 1 }, { 1, 1 }, { 2, 1 }, { 0, 2 }, { 1, 2 }, { 2, 2 } };
-    }
-    auto res = std::vector<cell_location>{ };
-    auto column = std::size_t{ 0 };
-    auto row = std::size_t{ 0 };
-    // Retrieve the board bits from the state.
-    auto board = st.board();
-    // For each of the 9 cells
-    for (auto i = 0; i < 9; ++i)
-    {
-      // If the cell is empty, push it.
-      if (!(board & details::state::ALL_CELL_BITS))
-      {
-        res.push_back({ column, row });
-      }
-      // Move to the next cell.
-      ++column;
-      if (column > 2)
-      {
-        ++row;
-        column = 0;
-      }
-      // Shift the current cell off the board.
-      board >>= 2;
-    }
-    return res;
-  }
-
   bool strategy::would_win(const details::state& st, const cell_location& next) const {
-    auto next_state = st;
-    next_state.cell(next.column, next.row, cell_contents::o);
-    return next_state.is_column_o(next.column) || next_state.is_row_o(next.row) || next_state.is_left_diagonal_o() ||
-           next_state.is_right_diagonal_o();
+    return st.completes_line(next.column, next.row, cell_contents::o);
   }
 
   bool strategy::would_lose(const details::state& st, const cell_location& next) const {
-    auto next_state = st;
-    next_state.cell(next.column, next.row, cell_contents::x);
-    return next_state.is_column_x(next.column) || next_state.is_row_x(next.row) || next_state.is_left_diagonal_x() ||
-           next_state.is_right_diagonal_x();
+    return st.completes_line(next.column, next.row, cell_contents::x);
   }
 
   cell_location strategy::find_win(const details::state& st) const {
     if (st.count_o() > 1)
     {
-      for (const auto& empty : find_empty_locations(st))
+      for (const auto empty : st.empty_cells())
       {
-        if (would_win(st, empty))
+        if (would_win(st, to_location(empty)))
         {
-          return empty;
+          return to_location(empty);
         }
       }
     }
     return INVALID_LOCATION;
   }
 
-  std::vector<cell_location> strategy::find_all_blocks(const details::state& st) const {
-    auto res = std::vector<cell_location>{ };
-    if (st.count_x() > 2)
-    {
-      for (const auto& empty : find_empty_locations(st))
-      {
-        if (would_lose(st, empty))
-        {
-          res.push_back(empty);
-        }
-      }
-    }
-    return res;
-  }
-
   cell_location strategy::find_block(const details::state& st) const {
     if (st.count_x() > 1)
     {
-      for (const auto& empty : find_empty_locations(st))
+      for (const auto empty : st.empty_cells())
       {
-        if (would_lose(st, empty))
+        if (would_lose(st, to_location(empty)))
         {
-          return empty;
+          return to_location(empty);
         }
       }
     }
     return INVALID_LOCATION;
   }
-  cell_location strategy::find_fork_block(const details::state& st) const {
-    // This bears some explanation.
-    // A fork is a position originating on turn 3 or turn 6 where a mistake by
-    // O allows X to win. In a fork position X can win in two different ways
-    // which prevents a block by O. Such a position arises two turns after the
-    // mistake by O and therefore requires additional foresight to prevent.
-    // A position is excluded from being a fork if O can win before X in the
-    // fork position.
-    //
-    // I think the complexity of this approach is something like O(n^4). Where n is the number of empty cells.
-    // Obviously, that's not ideal but this should only run twice at most.
-    auto available = std::vector<cell_location>{ };
-    for (const auto& empty : find_empty_locations(st))
-    {
-      auto next = st;
-      next.cell(empty.column, empty.row, cell_contents::o);
-      auto fork = false;
-      for (const auto& next_empty : find_empty_locations(next))
-      {
-        auto next_next = next;
-        next_next.cell(next_empty.column, next_empty.row, cell_contents::x);
-        auto blocks = find_all_blocks(next_next);
-        // A position is only a fork if O would need to block more than one win by X AND O cannot win on the next turn.
-        if (blocks.size() > 1 && !is_valid(find_win(next_next)))
-        {
-          fork = true;
-        }
-      }
-      if (!fork)
-      {
-        available.push_back(empty);
-      }
-    }
-    if (available.empty())
-    {
-      return INVALID_LOCATION;
-    }
-    auto selector = std::uniform_int_distribution<std::size_t>{ 0, available.size() - 1 };
-    return available[selector(m_prng)];
-  }
-
-  strategy::strategy() : m_prng{ std::random_device{ }() } { }
-
-  cell_location strategy::operator()(const game& g, const cell_location& last) const {
-    return run(g, last);
-  }
 
-  cell_location strategy::operator()(const details::state& st, const cell_location& last) const {
-    return run(st, last);
-  }
-
-  cell_location strategy::run(const game& g, const cell_location& last) const {
-    return run(g.state(), last);
-  }
-
-  cell_location strategy::run(const details::state& st, const cell_location& last) const {
+  details::cell_set strategy::heuristic_moves(const details::state& st, const cell_location& last) const {
     // Step 1: Win the game.
     if (auto res = find_win(st); is_valid(res))
     {
-      return res;
+      return to_cells(res);
     }
     // Step 2: Block a win.
     if (auto res = find_block(st); is_valid(res))
     {
-      return res;
+      return to_cells(res);
     }
-    if (st.filled_cells() == 3 || st.filled_cells() == 6)
+    if (st.filled_cells() == 3 || st.filled_cells() == 5)
     {
       // Step 3: Block forks.
-      if (auto res = find_fork_block(st); is_valid(res))
+      if (auto res = details::fork_blocks(st); !res.empty())
       {
         return res;
       }
     }
     // Step 4: Play the center.
-    if (st.is_cell_empty(1, 1))
+    if (st.cell<1, 1>() == cell_contents::empty)
     {
-      return { 1, 1 };
+      return to_cells({ 1, 1 });
     }
     // Step 5: Play an opposite corner.
     if (auto res = find_opposite_corner(st, last); is_valid(res))
     {
-      return res;
+      return to_cells(res);
     }
     // Step 6: Play an empty corner.
-    if (auto res = find_corner(st); is_valid(res))
+    if (auto res = find_corners(st); !res.empty())
     {
       return res;
     }
     // Step 7: Play an empty edge.
-    if (auto res = find_edge(st); is_valid(res))
+    return find_edges(st);
+  }
+
+  details::solver& strategy::solver() const {
+    // Moved from strategies lose their solver so it's created again on demand.
+    if (!m_solver)
+    {
+      m_solver = std::make_unique<details::solver>();
+    }
+    return *m_solver;
+  }
+
+  details::iterative_search<details::state>& strategy::search() const {
+    if (!m_search)
+    {
+      m_search = std::make_unique<details::iterative_search<details::state>>();
+    }
+    return *m_search;
+  }
+
+  strategy::strategy() : m_prng{ time_seed() } { }
+
+  strategy::strategy(const strategy_algorithm algorithm) : strategy{ algorithm, time_seed() } { }
+
+  strategy::strategy(const std::uint64_t seed) : m_prng{ seed } { }
+
+  strategy::strategy(const strategy_algorithm algorithm, const std::uint64_t seed) : m_prng{ seed },
+                                                                                     m_algorithm{ algorithm } {
+    switch (m_algorithm)
+    {
+    case strategy_algorithm::negamax:
+      // The table is allocated up front so that choosing a move never allocates.
+      solver();
+      search();
+      break;
+    case strategy_algorithm::heuristic:
+    case strategy_algorithm::book:
+      break;
+    default:
+      throw std::runtime_error{ "The strategy algorithm was invalid." };
+    }
+  }
+
+  strategy::strategy(const strategy& other) : m_prng{ other.m_prng }, m_algorithm{ other.m_algorithm } {
+    if (other.m_solver)
+    {
+      m_solver = std::make_unique<details::solver>(*other.m_solver);
+    }
+    if (other.m_search)
+    {
+      m_search = std::make_unique<details::iterative_search<details::state>>(*other.m_search);
+    }
+  }
+
+  strategy& strategy::operator=(const strategy& rhs) {
+    if (this != &rhs)
+    {
+      *this = strategy{ rhs };
+    }
+    return *this;
+  }
+
+  cell_location strategy::operator()(const game& g, const cell_location& last) const {
+    return run(g, last);
+  }
+
+  cell_location strategy::operator()(const details::state& st, const cell_location& last) const {
+    return run(st, last);
+  }
+
+  cell_location strategy::run(const game& g, const cell_location& last) const {
+    return run(g.state(), last);
+  }
+
+  cell_location strategy::run(const details::state& st, const cell_location& last) const {
+    if (auto res = select(candidates(st, last)); is_valid(res))
     {
       return res;
     }
     throw std::runtime_error{ "A valid move could not be located." };
   }
 
+  cell_location strategy::run(const game& g, const cell_location& last,
+                              const std::chrono::steady_clock::duration budget, const std::size_t node_limit) const {
+    return run(g.state(), last, budget, node_limit);
+  }
+
+  cell_location strategy::run(const details::state& st, const cell_location& last,
+                              const std::chrono::steady_clock::duration budget, const std::size_t node_limit) const {
+    if (m_algorithm == strategy_algorithm::negamax)
+    {
+      return to_location(search().run(st, budget, node_limit).move);
+    }
+    return run(st, last);
+  }
+
+  details::cell_set strategy::candidates(const details::state& st, const cell_location& last) const {
+    switch (m_algorithm)
+    {
+    case strategy_algorithm::negamax:
+      return details::cell_set{ std::uint32_t{ 1 } << solver().best_move(st) };
+    case strategy_algorithm::book:
+      return details::book_moves(st);
+    default:
+      return heuristic_moves(st, last);
+    }
+  }
+
+  strategy_algorithm strategy::algorithm() const {
+    return m_algorithm;
+  }
+
 }
@@ -0,0 +1,224 @@
+/**
+ * @file perft.cpp
+ * @brief Game state move generation benchmark application.
+ * @author Alexander Rothman <gnomesort@megate.ch>
+ * @date 2024
+ * @copyright AGPL-3.0+
+ */
+#include <cstddef>
+#include <cinttypes>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <megatech/ttt/enums.hpp>
+#include <megatech/ttt/utility.hpp>
+#include <megatech/ttt/details/state.hpp>
+
+namespace {
+
+  // The number of move sequences of each length from the empty board. A sequence stops as soon as either player wins.
+  constexpr std::array<std::uint64_t, 10> EMPTY_BOARD_NODES{ 1, 9, 72, 504, 3'024, 15'120, 54'720, 148'176,
+                                                              200'448, 127'872 };
+
+  // Multithreaded runs split the tree this many plies below the root.
+  constexpr std::size_t SPLIT_PLIES{ 2 };
+
+  struct position final {
+    megatech::ttt::details::state st;
+    megatech::ttt::cell_contents mark;
+  };
+
+  megatech::ttt::cell_contents opponent(const megatech::ttt::cell_contents mark) {
+    return mark == megatech::ttt::cell_contents::x ? megatech::ttt::cell_contents::o : megatech::ttt::cell_contents::x;
+  }
+
+  // Count the move sequences of exactly the given depth. Moves at the final ply are counted without being played.
+  std::uint64_t perft(const megatech::ttt::details::state& st, const megatech::ttt::cell_contents mark,
+                      const std::size_t depth) {
+    if (!depth)
+    {
+      return 1;
+    }
+    const auto empty = st.empty_cells();
+    if (depth == 1)
+    {
+      return empty.size();
+    }
+    auto res = std::uint64_t{ 0 };
+    for (const auto index : empty)
+    {
+      const auto column = index % 3;
+      const auto row = index / 3;
+      if (st.completes_line(column, row, mark))
+      {
+        continue;
+      }
+      auto next = st;
+      next.cell(column, row, mark);
+      res += perft(next, opponent(mark), depth - 1);
+    }
+    return res;
+  }
+
+  // Collect every position exactly plies moves below the root in which neither player has won.
+  void expand(const position& root, const std::size_t plies, std::vector<position>& out) {
+    if (!plies)
+    {
+      out.push_back(root);
+      return;
+    }
+    for (const auto index : root.st.empty_cells())
+    {
+      const auto column = index % 3;
+      const auto row = index / 3;
+      if (root.st.completes_line(column, row, root.mark))
+      {
+        continue;
+      }
+      auto next = root.st;
+      next.cell(column, row, root.mark);
+      expand({ next, opponent(root.mark) }, plies - 1, out);
+    }
+  }
+
+  // Run the given number of iterations of perft and return the nodes per second.
+  double measure(const position& root, const std::size_t depth, const std::size_t iterations,
+                 const std::size_t threads, const std::uint64_t expected) {
+    const auto plies = std::min(SPLIT_PLIES, depth - 1);
+    auto tasks = std::vector<position>{ };
+    expand(root, plies, tasks);
+    if (tasks.empty())
+    {
+      return 0.0;
+    }
+    // Workers claim (iteration, task) pairs from a single counter so that the load stays balanced even when there
+    // are fewer tasks than threads.
+    const auto total_tasks = tasks.size() * iterations;
+    auto next_task = std::atomic<std::size_t>{ 0 };
+    auto counts = std::vector<std::uint64_t>(threads);
+    const auto start = std::chrono::steady_clock::now();
+    {
+      auto workers = std::vector<std::jthread>{ };
+      for (auto i = std::size_t{ 0 }; i < threads; ++i)
+      {
+        workers.emplace_back([&, i]() {
+          auto count = std::uint64_t{ 0 };
+          for (auto k = next_task.fetch_add(1, std::memory_order_relaxed); k < total_tasks;
+               k = next_task.fetch_add(1, std::memory_order_relaxed))
+          {
+            const auto& task = tasks[k % tasks.size()];
+            count += perft(task.st, task.mark, depth - plies);
+          }
+          counts[i] = count;
+        });
+      }
+    }
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    auto nodes = std::uint64_t{ 0 };
+    for (const auto count : counts)
+    {
+      nodes += count;
+    }
+    if (nodes != expected * iterations)
+    {
+      throw std::runtime_error{ "The multithreaded node count did not match the single threaded node count." };
+    }
+    return static_cast<double>(nodes) / elapsed;
+  }
+
+  template <typename Type>
+  Type parse_number(const char *const arg, const std::string& what, std::ios_base& (*base)(std::ios_base&)) {
+    auto s_in = std::istringstream{ arg };
+    auto res = Type{ };
+    s_in >> base >> res;
+    if (s_in.fail() || !s_in.eof())
+    {
+      throw std::runtime_error{ "The " + what + " value could not be read." };
+    }
+    return res;
+  }
+
+}
+
+void display_help(const std::string& name, const std::string& message) {
+  std::cerr << message << std::endl;
+  std::cerr << "USAGE: " << name << " [DEPTH] [ITERATIONS] [THREADS] [STATE]" << std::endl;
+  std::cerr << "\tDEPTH is between 1 and 9. The default is 9." << std::endl;
+  std::cerr << "\tITERATIONS is the number of times each depth is searched. The default is 100." << std::endl;
+  std::cerr << "\tTHREADS is the number of threads used for the multithreaded run. The default is every available "
+            << "core." << std::endl;
+  std::cerr << "\tSTATE is a serialized game state in hexadecimal. The default is an empty board." << std::endl;
+}
+
+int main(int argc, char** argv) {
+  try
+  {
+    if (auto res = megatech::ttt::initialize(argc, argv); res)
+    {
+      return res;
+    }
+    auto depth = std::size_t{ 9 };
+    if (argc > 1)
+    {
+      depth = parse_number<std::size_t>(argv[1], "depth", std::dec);
+    }
+    if (depth < 1 || depth > 9)
+    {
+      throw std::runtime_error{ "The depth must be between 1 and 9." };
+    }
+    auto iterations = std::size_t{ 100 };
+    if (argc > 2)
+    {
+      iterations = parse_number<std::size_t>(argv[2], "iteration count", std::dec);
+    }
+    auto threads = std::size_t{ std::max(std::thread::hardware_concurrency(), 1u) };
+    if (argc > 3)
+    {
+      threads = parse_number<std::size_t>(argv[3], "thread count", std::dec);
+    }
+    if (!iterations || !threads)
+    {
+      throw std::runtime_error{ "At least one iteration and one thread are required." };
+    }
+    auto st = megatech::ttt::details::state{ };
+    if (argc > 4)
+    {
+      st = megatech::ttt::details::state{ parse_number<std::uint32_t>(argv[4], "state", std::hex) };
+    }
+    // X always moves first so the player to move follows from the number of marks.
+    const auto root = position{ st, st.count_x() > st.count_o() ? megatech::ttt::cell_contents::o :
+                                                                  megatech::ttt::cell_contents::x };
+    std::cout << std::setw(5) << "depth" << std::setw(12) << "nodes" << std::setw(18) << "nodes/s (1)"
+              << std::setw(18) << ("nodes/s (" + std::to_string(threads) + ")") << std::endl;
+    for (auto d = std::size_t{ 1 }; d <= depth; ++d)
+    {
+      const auto nodes = root.st.winner() == megatech::ttt::cell_contents::empty ? perft(root.st, root.mark, d) : 0;
+      if (st.is_board_empty() && nodes != EMPTY_BOARD_NODES[d])
+      {
+        throw std::runtime_error{ "The node count at depth " + std::to_string(d) + " was " + std::to_string(nodes) +
+                                  " but " + std::to_string(EMPTY_BOARD_NODES[d]) + " was expected." };
+      }
+      const auto single = nodes ? measure(root, d, iterations, 1, nodes) : 0.0;
+      const auto multi = nodes ? measure(root, d, iterations, threads, nodes) : 0.0;
+      std::cout << std::setw(5) << d << std::setw(12) << nodes << std::fixed << std::setprecision(0) << std::setw(18)
+                << single << std::setw(18) << multi << std::endl;
+    }
+  }
+  catch (const std::exception& err)
+  {
+    display_help(argv[0], err.what());
+    return 1;
+  }
+  return 0;
+}
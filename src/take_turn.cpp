@@ -55,7 +55,7 @@ int main(int argc, char** argv) {
     if (g.state().phase() == megatech::ttt::game_phase::turn_o &&
         g.state().mode() == megatech::ttt::game_mode::single_player)
     {
-      auto strat = megatech::ttt::strategy{ };
+      auto strat = megatech::ttt::strategy{ megatech::ttt::strategy_algorithm::book };
       auto location = strat(g, { column, row });
       g.take_turn(location.column, location.row);
     }
@@ -0,0 +1,350 @@
+/**
+ * @file tournament.cpp
+ * @brief Tic-Tac-Toe strategy self-play benchmark application.
+ * @author Alexander Rothman <gnomesort@megate.ch>
+ * @date 2024
+ * @copyright AGPL-3.0+
+ */
+#include <cstddef>
+#include <cinttypes>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <megatech/ttt/enums.hpp>
+#include <megatech/ttt/strategy.hpp>
+#include <megatech/ttt/utility.hpp>
+#include <megatech/ttt/details/prng.hpp>
+#include <megatech/ttt/details/state.hpp>
+
+namespace {
+
+  // A player is either a uniformly random mover or a strategy using one of the strategy algorithms.
+  struct player_kind final {
+    std::string name;
+    std::optional<megatech::ttt::strategy_algorithm> algorithm;
+  };
+
+  struct options final {
+    std::size_t games{ 1'000'000 };
+    player_kind x{ "random", std::nullopt };
+    player_kind o{ "book", megatech::ttt::strategy_algorithm::book };
+    std::size_t threads{ std::max(std::thread::hardware_concurrency(), 1u) };
+    std::uint64_t seed{ 0 };
+  };
+
+  // Move latencies are recorded in a log-linear histogram with 16 linear buckets for every power of two. Every
+  // recorded value is within 1/16th (about 6%) of its bucket's lower bound.
+  class latency_histogram final {
+  private:
+    static constexpr std::size_t SUB_BUCKETS{ 16 };
+    static constexpr std::size_t BUCKETS{ SUB_BUCKETS * 64 };
+
+    std::array<std::uint64_t, BUCKETS> m_counts{ };
+    std::uint64_t m_total{ };
+    std::uint64_t m_max{ };
+
+    static std::size_t bucket(const std::uint64_t ns) {
+      if (ns < SUB_BUCKETS)
+      {
+        return ns;
+      }
+      const auto exponent = static_cast<std::size_t>(std::bit_width(ns)) - 5;
+      return (exponent + 1) * SUB_BUCKETS + ((ns >> exponent) & (SUB_BUCKETS - 1));
+    }
+
+    static std::uint64_t lower_bound(const std::size_t index) {
+      if (index < SUB_BUCKETS)
+      {
+        return index;
+      }
+      const auto exponent = index / SUB_BUCKETS - 1;
+      return (SUB_BUCKETS + index % SUB_BUCKETS) << exponent;
+    }
+  public:
+    void record(const std::uint64_t ns) {
+      ++m_counts[bucket(ns)];
+      ++m_total;
+      m_max = std::max(m_max, ns);
+    }
+
+    void merge(const latency_histogram& other) {
+      for (auto i = std::size_t{ 0 }; i < BUCKETS; ++i)
+      {
+        m_counts[i] += other.m_counts[i];
+      }
+      m_total += other.m_total;
+      m_max = std::max(m_max, other.m_max);
+    }
+
+    std::uint64_t total() const {
+      return m_total;
+    }
+
+    std::uint64_t max() const {
+      return m_max;
+    }
+
+    std::uint64_t percentile(const double p) const {
+      const auto rank = static_cast<std::uint64_t>(p / 100.0 * static_cast<double>(m_total - 1));
+      auto seen = std::uint64_t{ 0 };
+      for (auto i = std::size_t{ 0 }; i < BUCKETS; ++i)
+      {
+        seen += m_counts[i];
+        if (seen > rank)
+        {
+          return lower_bound(i);
+        }
+      }
+      return m_max;
+    }
+  };
+
+  struct results final {
+    std::uint64_t games{ };
+    std::uint64_t x_wins{ };
+    std::uint64_t o_wins{ };
+    std::uint64_t draws{ };
+    latency_histogram x_latency{ };
+    latency_histogram o_latency{ };
+
+    void merge(const results& other) {
+      games += other.games;
+      x_wins += other.x_wins;
+      o_wins += other.o_wins;
+      draws += other.draws;
+      x_latency.merge(other.x_latency);
+      o_latency.merge(other.o_latency);
+    }
+  };
+
+  // One side of a game in progress. Random players draw moves from their own generator. Strategy players are timed.
+  class player final {
+  private:
+    std::optional<megatech::ttt::strategy> m_strategy{ };
+    megatech::ttt::details::prng m_prng;
+    latency_histogram& m_latency;
+  public:
+    player(const player_kind& kind, const std::uint64_t seed, latency_histogram& latency) :
+    m_prng{ seed }, m_latency{ latency } {
+      if (kind.algorithm)
+      {
+        m_strategy.emplace(*kind.algorithm, seed);
+      }
+    }
+
+    std::size_t move(const megatech::ttt::details::state& st, const megatech::ttt::cell_location& last) {
+      const auto empty = st.empty_cells();
+      if (!m_strategy)
+      {
+        auto res = empty.begin();
+        std::ranges::advance(res, static_cast<std::ptrdiff_t>(m_prng.below(empty.size())));
+        return *res;
+      }
+      const auto start = std::chrono::steady_clock::now();
+      const auto location = m_strategy->run(st, last);
+      const auto stop = std::chrono::steady_clock::now();
+      m_latency.record(std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count());
+      const auto res = location.row * 3 + location.column;
+      if (!empty.contains(res))
+      {
+        throw std::runtime_error{ "A strategy selected a cell that was not empty." };
+      }
+      return res;
+    }
+  };
+
+  void play_games(const options& opts, const std::size_t games, const std::uint64_t seed, results& res) {
+    // The two players never share a seed so that mirrored matchups don't produce correlated games.
+    auto x = player{ opts.x, seed * 2, res.x_latency };
+    auto o = player{ opts.o, seed * 2 + 1, res.o_latency };
+    for (auto i = std::size_t{ 0 }; i < games; ++i)
+    {
+      auto st = megatech::ttt::details::state{ };
+      auto last = megatech::ttt::cell_location{ 0, 0 };
+      auto mark = megatech::ttt::cell_contents::x;
+      while (true)
+      {
+        const auto cell = mark == megatech::ttt::cell_contents::x ? x.move(st, last) : o.move(st, last);
+        last = { cell % 3, cell / 3 };
+        if (st.completes_line(last.column, last.row, mark))
+        {
+          ++(mark == megatech::ttt::cell_contents::x ? res.x_wins : res.o_wins);
+          break;
+        }
+        st.cell(last.column, last.row, mark);
+        if (st.is_board_full())
+        {
+          ++res.draws;
+          break;
+        }
+        mark = mark == megatech::ttt::cell_contents::x ? megatech::ttt::cell_contents::o :
+                                                         megatech::ttt::cell_contents::x;
+      }
+      ++res.games;
+    }
+  }
+
+  player_kind parse_player(const std::string& name) {
+    const auto lower = megatech::ttt::tolower(name);
+    if (lower == "random")
+    {
+      return { lower, std::nullopt };
+    }
+    if (lower == "heuristic")
+    {
+      return { lower, megatech::ttt::strategy_algorithm::heuristic };
+    }
+    if (lower == "negamax")
+    {
+      return { lower, megatech::ttt::strategy_algorithm::negamax };
+    }
+    if (lower == "book")
+    {
+      return { lower, megatech::ttt::strategy_algorithm::book };
+    }
+    throw std::runtime_error{ "The player \"" + name + "\" is not recognized." };
+  }
+
+  template <typename Type>
+  Type parse_number(const char *const arg, const std::string& what) {
+    auto s_in = std::istringstream{ arg };
+    auto res = Type{ };
+    s_in >> res;
+    if (s_in.fail() || !s_in.eof())
+    {
+      throw std::runtime_error{ "The " + what + " value could not be read." };
+    }
+    return res;
+  }
+
+  options parse_options(const int argc, const char *const *const argv) {
+    auto res = options{ };
+    if (argc > 1)
+    {
+      res.games = parse_number<std::size_t>(argv[1], "game count");
+    }
+    if (argc > 2)
+    {
+      res.x = parse_player(argv[2]);
+    }
+    if (argc > 3)
+    {
+      res.o = parse_player(argv[3]);
+    }
+    if (argc > 4)
+    {
+      res.threads = parse_number<std::size_t>(argv[4], "thread count");
+    }
+    if (argc > 5)
+    {
+      res.seed = parse_number<std::uint64_t>(argv[5], "seed");
+    }
+    // The heuristic and the book only know how to play as O. The solver plays whichever side is to move.
+    if (res.x.algorithm && *res.x.algorithm != megatech::ttt::strategy_algorithm::negamax)
+    {
+      throw std::runtime_error{ "Only the \"random\" and \"negamax\" players can play as X." };
+    }
+    if (res.threads == 0)
+    {
+      throw std::runtime_error{ "At least one thread is required." };
+    }
+    res.threads = std::min(res.threads, std::max(res.games, std::size_t{ 1 }));
+    return res;
+  }
+
+  void report_latency(const std::string& name, const latency_histogram& latency) {
+    if (!latency.total())
+    {
+      return;
+    }
+    std::cout << name << " move latency (ns): p50 " << latency.percentile(50.0) << ", p90 "
+              << latency.percentile(90.0) << ", p99 " << latency.percentile(99.0) << ", p99.9 "
+              << latency.percentile(99.9) << ", max " << latency.max() << std::endl;
+  }
+
+}
+
+void display_help(const std::string& name, const std::string& message) {
+  std::cerr << message << std::endl;
+  std::cerr << "USAGE: " << name << " [GAMES] [X_PLAYER] [O_PLAYER] [THREADS] [SEED]" << std::endl;
+  std::cerr << "\tPlayers are \"random\", \"heuristic\", \"negamax\", or \"book\". Only \"random\" and \"negamax\" "
+            << "can play as X." << std::endl;
+  std::cerr << "\tThe defaults are 1000000 games of random against book using every available core and a seed of 0."
+            << std::endl;
+}
+
+int main(int argc, char** argv) {
+  try
+  {
+    if (auto res = megatech::ttt::initialize(argc, argv); res)
+    {
+      return res;
+    }
+    const auto opts = parse_options(argc, argv);
+    auto thread_results = std::vector<results>(opts.threads);
+    auto errors = std::vector<std::exception_ptr>(opts.threads);
+    const auto start = std::chrono::steady_clock::now();
+    {
+      auto threads = std::vector<std::jthread>{ };
+      for (auto i = std::size_t{ 0 }; i < opts.threads; ++i)
+      {
+        // Games are divided as evenly as possible. Each thread derives its own seed so that runs are reproducible
+        // for a given seed and thread count.
+        const auto games = opts.games / opts.threads + (i < opts.games % opts.threads);
+        threads.emplace_back([&, i, games]() {
+          try
+          {
+            play_games(opts, games, opts.seed * opts.threads + i, thread_results[i]);
+          }
+          catch (...)
+          {
+            errors[i] = std::current_exception();
+          }
+        });
+      }
+    }
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    for (const auto& error : errors)
+    {
+      if (error)
+      {
+        std::rethrow_exception(error);
+      }
+    }
+    auto total = results{ };
+    for (const auto& res : thread_results)
+    {
+      total.merge(res);
+    }
+    const auto percent = [&](const std::uint64_t count) {
+      return total.games ? 100.0 * static_cast<double>(count) / static_cast<double>(total.games) : 0.0;
+    };
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << opts.x.name << " (X) vs. " << opts.o.name << " (O): " << total.games << " games on " << opts.threads
+              << " threads in " << elapsed << " s" << std::endl;
+    std::cout << "Throughput: " << static_cast<double>(total.games) / elapsed << " games/s" << std::endl;
+    std::cout << "X wins: " << total.x_wins << " (" << percent(total.x_wins) << "%)" << std::endl;
+    std::cout << "O wins: " << total.o_wins << " (" << percent(total.o_wins) << "%)" << std::endl;
+    std::cout << "Draws: " << total.draws << " (" << percent(total.draws) << "%)" << std::endl;
+    report_latency("X", total.x_latency);
+    report_latency("O", total.o_latency);
+  }
+  catch (const std::exception& err)
+  {
+    display_help(argv[0], err.what());
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,147 @@
+/**
+ * @file verify_strategy.cpp
+ * @brief Exhaustive CPU player strategy verification application.
+ * @author Alexander Rothman <gnomesort@megate.ch>
+ * @date 2024
+ * @copyright AGPL-3.0+
+ */
+#include <cstddef>
+#include <cinttypes>
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <megatech/ttt/enums.hpp>
+#include <megatech/ttt/strategy.hpp>
+#include <megatech/ttt/utility.hpp>
+#include <megatech/ttt/details/state.hpp>
+#include <megatech/ttt/details/verifier.hpp>
+
+namespace {
+
+  struct named_algorithm final {
+    std::string name;
+    megatech::ttt::strategy_algorithm algorithm;
+  };
+
+  const std::vector<named_algorithm> ALGORITHMS{
+    { "heuristic", megatech::ttt::strategy_algorithm::heuristic },
+    { "negamax", megatech::ttt::strategy_algorithm::negamax },
+    { "book", megatech::ttt::strategy_algorithm::book }
+  };
+
+  template <typename Type>
+  Type parse_number(const char *const arg, const std::string& what) {
+    auto s_in = std::istringstream{ arg };
+    auto res = Type{ };
+    s_in >> res;
+    if (s_in.fail() || !s_in.eof())
+    {
+      throw std::runtime_error{ "The " + what + " value could not be read." };
+    }
+    return res;
+  }
+
+  std::vector<named_algorithm> parse_algorithms(const std::string& name) {
+    const auto lower = megatech::ttt::tolower(name);
+    if (lower == "all")
+    {
+      return ALGORITHMS;
+    }
+    for (const auto& algorithm : ALGORITHMS)
+    {
+      if (algorithm.name == lower)
+      {
+        return { algorithm };
+      }
+    }
+    throw std::runtime_error{ "The algorithm \"" + name + "\" is not recognized." };
+  }
+
+  void display_board(const megatech::ttt::details::state& st) {
+    for (auto row = std::size_t{ 0 }; row < 3; ++row)
+    {
+      std::cout << "\t";
+      for (auto column = std::size_t{ 0 }; column < 3; ++column)
+      {
+        switch (st.cell(column, row))
+        {
+        case megatech::ttt::cell_contents::x:
+          std::cout << 'X';
+          break;
+        case megatech::ttt::cell_contents::o:
+          std::cout << 'O';
+          break;
+        default:
+          std::cout << '.';
+          break;
+        }
+      }
+      std::cout << std::endl;
+    }
+  }
+
+}
+
+void display_help(const std::string& name, const std::string& message) {
+  std::cerr << message << std::endl;
+  std::cerr << "USAGE: " << name << " [ALGORITHM] [THREADS] [SEED]" << std::endl;
+  std::cerr << "\tALGORITHM is \"heuristic\", \"negamax\", \"book\", or \"all\". The default is \"all\"." << std::endl;
+  std::cerr << "\tThe default is to use every available core and a seed of 0." << std::endl;
+}
+
+int main(int argc, char** argv) {
+  try
+  {
+    if (auto res = megatech::ttt::initialize(argc, argv); res)
+    {
+      return res;
+    }
+    auto algorithms = argc > 1 ? parse_algorithms(argv[1]) : ALGORITHMS;
+    auto threads = std::size_t{ std::max(std::thread::hardware_concurrency(), 1u) };
+    if (argc > 2)
+    {
+      threads = parse_number<std::size_t>(argv[2], "thread count");
+    }
+    auto seed = std::uint64_t{ 0 };
+    if (argc > 3)
+    {
+      seed = parse_number<std::uint64_t>(argv[3], "seed");
+    }
+    auto failed = false;
+    for (const auto& algorithm : algorithms)
+    {
+      const auto start = std::chrono::steady_clock::now();
+      const auto res = megatech::ttt::details::verify_strategy(algorithm.algorithm, seed, threads);
+      const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+      std::cout << algorithm.name << ": " << res.nodes << " nodes, " << res.games << " games (X wins " << res.x_wins
+                << ", O wins " << res.o_wins << ", draws " << res.draws << ") on " << threads << " threads in "
+                << std::fixed << std::setprecision(3) << elapsed << " ms" << std::endl;
+      if (res.loss)
+      {
+        std::cout << algorithm.name << " can lose. For example:" << std::endl;
+        display_board(*res.loss);
+        failed = true;
+      }
+      else
+      {
+        std::cout << algorithm.name << " never loses." << std::endl;
+      }
+    }
+    return failed;
+  }
+  catch (const std::exception& err)
+  {
+    display_help(argv[0], err.what());
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,219 @@
+/**
+ * @file basic_state.cpp
+ * @brief Generalized m,n,k game state test.
+ * @author Alexander Rothman <gnomesort@megate.ch>
+ * @date 2024
+ * @copyright AGPL-3.0+
+ */
+#include <cassert>
+#include <cstddef>
+#include <cinttypes>
+
+#include <array>
+#include <random>
+#include <stdexcept>
+
+#include <megatech/ttt/enums.hpp>
+#include <megatech/ttt/details/basic_state.hpp>
+#include <megatech/ttt/details/state.hpp>
+
+static_assert(megatech::ttt::details::state::COLUMNS == 3);
+static_assert(megatech::ttt::details::state::ROWS == 3);
+static_assert(megatech::ttt::details::state::LINE_LENGTH == 3);
+
+constexpr std::array<std::array<std::ptrdiff_t, 2>, 4> DIRECTIONS{ { { 1, 0 }, { 0, 1 }, { 1, 1 }, { -1, 1 } } };
+
+// Count the run of value starting at (column, row) and continuing in the direction (dc, dr).
+template <typename State>
+std::size_t run_length(const State& st, std::ptrdiff_t column, std::ptrdiff_t row, const std::ptrdiff_t dc,
+                       const std::ptrdiff_t dr, const megatech::ttt::cell_contents value) {
+  auto res = std::size_t{ 0 };
+  while (column >= 0 && row >= 0 && column < static_cast<std::ptrdiff_t>(State::COLUMNS) &&
+         row < static_cast<std::ptrdiff_t>(State::ROWS) && st.cell(column, row) == value)
+  {
+    ++res;
+    column += dc;
+    row += dr;
+  }
+  return res;
+}
+
+template <typename State>
+bool slow_has_line(const State& st, const megatech::ttt::cell_contents value) {
+  for (auto row = std::size_t{ 0 }; row < State::ROWS; ++row)
+  {
+    for (auto column = std::size_t{ 0 }; column < State::COLUMNS; ++column)
+    {
+      for (const auto& [dc, dr] : DIRECTIONS)
+      {
+        if (run_length(st, column, row, dc, dr, value) >= State::LINE_LENGTH)
+        {
+          return true;
+        }
+      }
+    }
+  }
+  return false;
+}
+
+template <typename State>
+State random_state(std::mt19937& rng, const std::size_t marks) {
+  auto st = State{ };
+  auto cell = std::uniform_int_distribution<std::size_t>{ 0, State::CELLS - 1 };
+  auto value = std::uniform_int_distribution<std::uint32_t>{ 1, 2 };
+  for (auto i = std::size_t{ 0 }; i < marks; ++i)
+  {
+    const auto index = cell(rng);
+    st.cell(index % State::COLUMNS, index / State::COLUMNS, static_cast<megatech::ttt::cell_contents>(value(rng)));
+  }
+  return st;
+}
+
+template <typename State>
+void test_queries() {
+  auto rng = std::mt19937{ 42 };
+  for (auto i = std::size_t{ 0 }; i < 2'000; ++i)
+  {
+    const auto st = random_state<State>(rng, i % (State::CELLS + 1));
+    const auto x_wins = slow_has_line(st, megatech::ttt::cell_contents::x);
+    const auto o_wins = slow_has_line(st, megatech::ttt::cell_contents::o);
+    const auto winner = st.winner();
+    assert(x_wins || o_wins ? winner != megatech::ttt::cell_contents::empty :
+                              winner == megatech::ttt::cell_contents::empty);
+    assert(winner != megatech::ttt::cell_contents::x || x_wins);
+    assert(winner != megatech::ttt::cell_contents::o || o_wins);
+    assert(st.count_x() + st.count_o() == st.filled_cells());
+    assert(st.empty_cells().size() == State::CELLS - st.filled_cells());
+    assert(st.is_board_full() == (st.filled_cells() == State::CELLS));
+    assert(st.is_board_empty() == (st.filled_cells() == 0));
+    for (auto index = std::size_t{ 0 }; index < State::CELLS; ++index)
+    {
+      const auto column = index % State::COLUMNS;
+      const auto row = index / State::COLUMNS;
+      assert(st.unchecked_cell(column, row) == st.cell(column, row));
+      assert(st.x_cells().contains(index) == (st.cell(column, row) == megatech::ttt::cell_contents::x));
+      assert(st.o_cells().contains(index) == (st.cell(column, row) == megatech::ttt::cell_contents::o));
+      for (const auto value : { megatech::ttt::cell_contents::x, megatech::ttt::cell_contents::o })
+      {
+        auto next = st;
+        next.cell(column, row, value);
+        // A line through the cell exists in the marked board exactly when marking the cell completes it.
+        auto expected = false;
+        for (const auto& [dc, dr] : DIRECTIONS)
+        {
+          const auto forward = run_length(next, column, row, dc, dr, value);
+          const auto backward = run_length(next, column, row, -dc, -dr, value);
+          expected = expected || forward + backward - 1 >= State::LINE_LENGTH;
+        }
+        assert(st.completes_line(column, row, value) == expected);
+      }
+      assert(!st.completes_line(column, row, megatech::ttt::cell_contents::empty));
+    }
+  }
+}
+
+template <typename State>
+void test_hash() {
+  auto rng = std::mt19937{ 7 };
+  assert(State{ }.hash() == 0);
+  for (auto i = std::size_t{ 0 }; i < 200; ++i)
+  {
+    const auto st = random_state<State>(rng, State::CELLS / 2);
+    // Rebuilding the same board in reverse order must produce the same hash.
+    auto copy = State{ };
+    for (auto index = State::CELLS; index-- > 0;)
+    {
+      copy.cell(index % State::COLUMNS, index / State::COLUMNS,
+                st.cell(index % State::COLUMNS, index / State::COLUMNS));
+    }
+    assert(copy.hash() == st.hash());
+    for (auto index = std::size_t{ 0 }; index < State::CELLS; ++index)
+    {
+      copy.cell(index % State::COLUMNS, index / State::COLUMNS, megatech::ttt::cell_contents::empty);
+    }
+    assert(copy.hash() == 0);
+  }
+}
+
+template <typename State>
+void test_symmetries() {
+  auto rng = std::mt19937{ 99 };
+  for (auto i = std::size_t{ 0 }; i < 200; ++i)
+  {
+    auto st = random_state<State>(rng, i % State::CELLS);
+    st.phase(megatech::ttt::game_phase::turn_o);
+    const auto [canonical, canonical_sym] = st.canonical();
+    assert(st.transformed(canonical_sym).hash() == canonical.hash());
+    for (auto sym = std::uint32_t{ 0 }; sym < 8; ++sym)
+    {
+      const auto next = st.transformed(static_cast<megatech::ttt::details::symmetry>(sym));
+      assert(next.phase() == st.phase());
+      assert(next.filled_cells() == st.filled_cells());
+      assert((next.winner() == megatech::ttt::cell_contents::empty) ==
+             (st.winner() == megatech::ttt::cell_contents::empty));
+      const auto inverse = megatech::ttt::details::inverse(static_cast<megatech::ttt::details::symmetry>(sym));
+      const auto back = next.transformed(inverse);
+      assert(back.x_cells() == st.x_cells());
+      assert(back.o_cells() == st.o_cells());
+      assert(back.hash() == st.hash());
+      assert(next.canonical().first.x_cells() == canonical.x_cells());
+      assert(next.canonical().first.o_cells() == canonical.o_cells());
+    }
+  }
+}
+
+void test_lines() {
+  // A 15x15 board with a 5 in a row crossing the boundary between the first two words of each plane.
+  auto st = megatech::ttt::details::basic_state<15, 15, 5>{ };
+  for (auto column = std::size_t{ 2 }; column < 6; ++column)
+  {
+    st.cell(column, 4, megatech::ttt::cell_contents::o);
+  }
+  assert(st.winner() == megatech::ttt::cell_contents::empty);
+  assert(st.completes_line(6, 4, megatech::ttt::cell_contents::o));
+  assert(st.completes_line(1, 4, megatech::ttt::cell_contents::o));
+  assert(!st.completes_line(7, 4, megatech::ttt::cell_contents::o));
+  assert(!st.completes_line(6, 4, megatech::ttt::cell_contents::x));
+  st.cell(6, 4, megatech::ttt::cell_contents::o);
+  assert(st.winner() == megatech::ttt::cell_contents::o);
+  // Full line queries cover the entire row, column, or diagonal.
+  auto small = megatech::ttt::details::basic_state<4, 4, 3>{ };
+  for (auto i = std::size_t{ 0 }; i < 4; ++i)
+  {
+    small.cell(i, i, megatech::ttt::cell_contents::x);
+    small.cell(3 - i, i, megatech::ttt::cell_contents::o);
+  }
+  assert(small.is_left_diagonal_x());
+  assert(small.is_right_diagonal_o());
+  assert(!small.is_row_x(0));
+  assert(!small.is_column_o(0));
+  try
+  {
+    small.cell(4, 0, megatech::ttt::cell_contents::x);
+    assert(false);
+  }
+  catch (const std::runtime_error&) { }
+  try
+  {
+    [[maybe_unused]] const auto value = small.cell(0, 4);
+    assert(false);
+  }
+  catch (const std::runtime_error&) { }
+  assert((small.cell<0, 0>() == megatech::ttt::cell_contents::x));
+  assert((small.cell<3, 0>() == megatech::ttt::cell_contents::o));
+}
+
+int main() {
+  test_queries<megatech::ttt::details::basic_state<4, 4, 3>>();
+  test_queries<megatech::ttt::details::basic_state<4, 4, 4>>();
+  test_queries<megatech::ttt::details::basic_state<5, 5, 4>>();
+  test_queries<megatech::ttt::details::basic_state<7, 6, 4>>();
+  test_queries<megatech::ttt::details::basic_state<15, 15, 5>>();
+  test_hash<megatech::ttt::details::basic_state<4, 4, 3>>();
+  test_hash<megatech::ttt::details::basic_state<15, 15, 5>>();
+  test_symmetries<megatech::ttt::details::basic_state<4, 4, 3>>();
+  test_symmetries<megatech::ttt::details::basic_state<5, 5, 4>>();
+  test_symmetries<megatech::ttt::details::basic_state<15, 15, 5>>();
+  test_lines();
+  return 0;
+}
@@ -0,0 +1,123 @@
+/**
+ * @file bitboard.cpp
+ * @brief Bit-sliced game state test.
+ * @author Alexander Rothman <gnomesort@megate.ch>
+ * @date 2024
+ * @copyright AGPL-3.0+
+ */
+#include <cassert>
+#include <cstddef>
+#include <cinttypes>
+
+#include <array>
+#include <stdexcept>
+
+#include <megatech/ttt/enums.hpp>
+#include <megatech/ttt/details/cell_set.hpp>
+#include <megatech/ttt/details/state.hpp>
+#include <megatech/ttt/details/bitboard.hpp>
+
+#include "test_states.hpp"
+
+constexpr std::array<megatech::ttt::game_phase, 5> ALL_PHASES{ megatech::ttt::game_phase::turn_x,
+                                                               megatech::ttt::game_phase::turn_o,
+                                                               megatech::ttt::game_phase::win_x,
+                                                               megatech::ttt::game_phase::win_o,
+                                                               megatech::ttt::game_phase::draw };
+
+void test_conversion() {
+  for (auto i = std::size_t{ 0 }; i < 19'683; ++i)
+  {
+    auto st = state_from_index(i);
+    for (const auto mode : { megatech::ttt::game_mode::single_player, megatech::ttt::game_mode::multiplayer })
+    {
+      for (const auto phase : ALL_PHASES)
+      {
+        st.mode(mode);
+        st.phase(phase);
+        const auto board = megatech::ttt::details::bitboard{ st };
+        assert(board.mode() == mode);
+        assert(board.phase() == phase);
+        assert(static_cast<std::uint32_t>(static_cast<megatech::ttt::details::state>(board)) ==
+               static_cast<std::uint32_t>(st));
+      }
+    }
+  }
+}
+
+void test_queries() {
+  for (auto i = std::size_t{ 0 }; i < 19'683; ++i)
+  {
+    const auto st = state_from_index(i);
+    const auto board = megatech::ttt::details::bitboard{ st };
+    assert(static_cast<std::uint32_t>(board.x_cells()) == static_cast<std::uint32_t>(st.x_cells()));
+    assert(static_cast<std::uint32_t>(board.o_cells()) == static_cast<std::uint32_t>(st.o_cells()));
+    assert(static_cast<std::uint32_t>(board.empty_cells()) == static_cast<std::uint32_t>(st.empty_cells()));
+    assert(board.filled_cells() == st.filled_cells());
+    assert(board.winner() == st.winner());
+    assert(board.is_board_full() == st.is_board_full());
+    assert(board.player_to_move() == (st.count_x() > st.count_o() ? megatech::ttt::cell_contents::o :
+                                                                    megatech::ttt::cell_contents::x));
+    for (auto cell = std::size_t{ 0 }; cell < 9; ++cell)
+    {
+      assert(board.cell(cell) == st.cell(cell % 3, cell / 3));
+    }
+    assert(board.cell(9) == megatech::ttt::cell_contents::empty);
+  }
+}
+
+void test_modification() {
+  auto board = megatech::ttt::details::bitboard{ };
+  auto st = megatech::ttt::details::state{ };
+  const auto moves = std::array<std::size_t, 5>{ 4, 0, 8, 2, 6 };
+  auto player = megatech::ttt::cell_contents::x;
+  for (const auto cell : moves)
+  {
+    board.cell(cell, player);
+    st.cell(cell % 3, cell / 3, player);
+    assert(board == megatech::ttt::details::bitboard{ st });
+    player = player == megatech::ttt::cell_contents::x ? megatech::ttt::cell_contents::o :
+                                                         megatech::ttt::cell_contents::x;
+  }
+  // Overwriting a cell moves it between planes.
+  board.cell(4, megatech::ttt::cell_contents::o);
+  assert(board.cell(4) == megatech::ttt::cell_contents::o);
+  assert(!board.x_cells().contains(4));
+  board.cell(4, megatech::ttt::cell_contents::empty);
+  assert(board.empty_cells().contains(4));
+  board.cell(9, megatech::ttt::cell_contents::x);
+  assert(board.filled_cells() == 4);
+  board.mode(megatech::ttt::game_mode::multiplayer);
+  board.phase(megatech::ttt::game_phase::draw);
+  assert(static_cast<megatech::ttt::details::state>(board).mode() == megatech::ttt::game_mode::multiplayer);
+  assert(static_cast<megatech::ttt::details::state>(board).phase() == megatech::ttt::game_phase::draw);
+  try
+  {
+    board.phase(static_cast<megatech::ttt::game_phase>(0x50'00'00'00));
+    assert(false);
+  }
+  catch (const std::runtime_error&) { }
+}
+
+void test_planes() {
+  constexpr auto board = megatech::ttt::details::bitboard{ megatech::ttt::details::cell_set{ 0x00'00'00'07 },
+                                                           megatech::ttt::details::cell_set{ 0x00'00'00'18 } };
+  static_assert(board.winner() == megatech::ttt::cell_contents::x);
+  static_assert(board.filled_cells() == 5);
+  static_assert(board.player_to_move() == megatech::ttt::cell_contents::o);
+  try
+  {
+    [[maybe_unused]] const auto bad = megatech::ttt::details::bitboard{ megatech::ttt::details::cell_set{ 0x01 },
+                                                                        megatech::ttt::details::cell_set{ 0x03 } };
+    assert(false);
+  }
+  catch (const std::runtime_error&) { }
+}
+
+int main() {
+  test_conversion();
+  test_queries();
+  test_modification();
+  test_planes();
+  return 0;
+}
@@ -0,0 +1,81 @@
+/**
+ * @file book.cpp
+ * @brief Precomputed optimal move table test.
+ * @author Alexander Rothman <gnomesort@megate.ch>
+ * @date 2024
+ * @copyright AGPL-3.0+
+ */
+#include <cassert>
+#include <cstddef>
+#include <cinttypes>
+
+#include <megatech/ttt/enums.hpp>
+#include <megatech/ttt/details/state.hpp>
+#include <megatech/ttt/details/solver.hpp>
+#include <megatech/ttt/details/book.hpp>
+
+#include "test_states.hpp"
+
+// Score a move with the solver using the same rules the book is generated with.
+int score_move(megatech::ttt::details::solver& s, const megatech::ttt::details::state& st, const std::size_t cell) {
+  if (st.completes_line(cell % 3, cell / 3, megatech::ttt::cell_contents::o))
+  {
+    return 10 - static_cast<int>(st.filled_cells());
+  }
+  auto next = st;
+  next.cell(cell % 3, cell / 3, megatech::ttt::cell_contents::o);
+  if (next.is_board_full())
+  {
+    return 0;
+  }
+  return -s.evaluate(next);
+}
+
+void test_book_matches_solver() {
+  auto s = megatech::ttt::details::solver{ };
+  auto checked = std::size_t{ 0 };
+  // Compare the book against the solver at every reachable position.
+  visit_reachable([&](const megatech::ttt::details::state& st, const megatech::ttt::cell_contents player) {
+    const auto moves = megatech::ttt::details::book_moves(st);
+    if (st.winner() != megatech::ttt::cell_contents::empty || st.is_board_full() ||
+        player != megatech::ttt::cell_contents::o)
+    {
+      assert(moves.empty());
+      return;
+    }
+    auto best = -100;
+    for (const auto cell : st.empty_cells())
+    {
+      const auto score = score_move(s, st, cell);
+      best = score > best ? score : best;
+    }
+    auto expected = megatech::ttt::details::cell_set{ };
+    for (const auto cell : st.empty_cells())
+    {
+      if (score_move(s, st, cell) == best)
+      {
+        expected.insert(cell);
+      }
+    }
+    assert(static_cast<std::uint32_t>(moves) == static_cast<std::uint32_t>(expected));
+    ++checked;
+  });
+  assert(checked > 0);
+}
+
+void test_mode_and_phase_ignored() {
+  auto st = megatech::ttt::details::state{ };
+  st.cell(0, 0, megatech::ttt::cell_contents::x);
+  const auto expected = static_cast<std::uint32_t>(megatech::ttt::details::book_moves(st));
+  // The only move that doesn't lose against a corner opening is the center.
+  assert(expected == 0x10);
+  st.mode(megatech::ttt::game_mode::multiplayer);
+  st.phase(megatech::ttt::game_phase::turn_o);
+  assert(static_cast<std::uint32_t>(megatech::ttt::details::book_moves(st)) == expected);
+}
+
+int main() {
+  test_book_matches_solver();
+  test_mode_and_phase_ignored();
+  return 0;
+}
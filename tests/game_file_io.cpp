@@ -8,15 +8,20 @@
 #include <cassert>
 #include <cstring>
 #include <cstddef>
+#include <cinttypes>
 
+#include <chrono>
 #include <filesystem>
 #include <fstream>
+#include <stdexcept>
 
 #include <megatech/ttt/game.hpp>
 #include <megatech/ttt/details/data_file.hpp>
+#include <megatech/ttt/details/mapped_file.hpp>
 
 #define GAME_FILE_NAME ".ttt"
 #define LOCK_FILE_NAME ".~lock.ttt"
+#define TEMPORARY_FILE_NAME ".~new.ttt"
 
 void test_new_game_read_write() {
   std::filesystem::remove_all(GAME_FILE_NAME);
@@ -164,6 +169,286 @@ void test_state_byteswapping() {
   std::filesystem::remove_all(GAME_FILE_NAME);
 }
 
+void test_read_only() {
+  constexpr const auto STATE_VALUE = 0x90'01'55'55;
+  constexpr const auto REVERSE_STATE_VALUE = 0x55'55'01'90;
+  std::filesystem::remove_all(GAME_FILE_NAME);
+  try
+  {
+    auto g = megatech::ttt::game{ GAME_FILE_NAME, megatech::ttt::open_mode::read_only };
+    assert(false);
+  }
+  catch (const std::runtime_error&) { }
+  // A reversed byte order file would be rewritten in the system byte order by any write back.
+  {
+    auto f_out = std::ofstream{ GAME_FILE_NAME, std::ios::binary | std::ios::trunc };
+    auto header = megatech::ttt::details::data_file_header{ };
+    std::memcpy(header.magic, megatech::ttt::details::DATA_FILE_HEADER_MAGIC,
+                megatech::ttt::details::DATA_FILE_HEADER_MAGIC_LENGTH);
+    header.version = megatech::ttt::details::DATA_FILE_VERSION_1;
+    f_out.write(reinterpret_cast<char*>(&header), sizeof(megatech::ttt::details::data_file_header));
+    auto body = megatech::ttt::details::data_file_body_v1{ };
+    body.endianness = megatech::ttt::details::DATA_FILE_REVERSE_ENDIANNESS;
+    body.state = REVERSE_STATE_VALUE;
+    f_out.write(reinterpret_cast<char*>(&body), sizeof(megatech::ttt::details::data_file_body_v1));
+  }
+  {
+    auto g = megatech::ttt::game{ GAME_FILE_NAME, megatech::ttt::open_mode::read_only };
+    // Readers don't lock the file so they can be opened alongside each other.
+    auto other = megatech::ttt::game{ GAME_FILE_NAME, megatech::ttt::open_mode::read_only };
+    assert(!std::filesystem::exists(LOCK_FILE_NAME));
+    assert(static_cast<std::uint32_t>(g.state()) == STATE_VALUE);
+    assert(static_cast<std::uint32_t>(other.state()) == STATE_VALUE);
+    try
+    {
+      g.take_turn(0, 0);
+      assert(false);
+    }
+    catch (const std::runtime_error&) { }
+    assert(static_cast<std::uint32_t>(g.state()) == STATE_VALUE);
+  }
+  auto f_in = std::ifstream{ GAME_FILE_NAME, std::ios::binary };
+  auto header = megatech::ttt::details::data_file_header{ };
+  f_in.read(reinterpret_cast<char*>(&header), sizeof(megatech::ttt::details::data_file_header));
+  auto body = megatech::ttt::details::data_file_body_v1{ };
+  f_in.read(reinterpret_cast<char*>(&body), sizeof(megatech::ttt::details::data_file_body_v1));
+  assert(body.endianness == megatech::ttt::details::DATA_FILE_REVERSE_ENDIANNESS);
+  assert(body.state == REVERSE_STATE_VALUE);
+  std::filesystem::remove_all(GAME_FILE_NAME);
+}
+
+void test_write_back() {
+  std::filesystem::remove_all(GAME_FILE_NAME);
+  {
+    auto g = megatech::ttt::game{ GAME_FILE_NAME, megatech::ttt::game_mode::multiplayer };
+  }
+  // Games that aren't changed must not be rewritten.
+  const auto old_time = std::filesystem::last_write_time(GAME_FILE_NAME) - std::chrono::hours{ 1 };
+  std::filesystem::last_write_time(GAME_FILE_NAME, old_time);
+  {
+    auto g = megatech::ttt::game{ GAME_FILE_NAME };
+  }
+  assert(std::filesystem::last_write_time(GAME_FILE_NAME) == old_time);
+  // Every policy must produce the same file.
+  for (const auto policy : { megatech::ttt::sync_policy::none, megatech::ttt::sync_policy::data,
+                             megatech::ttt::sync_policy::full })
+  {
+    auto expected = std::uint32_t{ };
+    {
+      auto g = megatech::ttt::game{ GAME_FILE_NAME };
+      assert(g.synchronization() == megatech::ttt::sync_policy::none);
+      g.synchronization(policy);
+      assert(g.synchronization() == policy);
+      g.take_turn(static_cast<std::size_t>(policy), 0);
+      expected = static_cast<std::uint32_t>(g.state());
+    }
+    assert(!std::filesystem::exists(TEMPORARY_FILE_NAME));
+    assert(!std::filesystem::exists(LOCK_FILE_NAME));
+    assert(std::filesystem::file_size(GAME_FILE_NAME) == sizeof(megatech::ttt::details::data_file_header) +
+                                                         sizeof(megatech::ttt::details::data_file_body_v1));
+    auto g = megatech::ttt::game{ GAME_FILE_NAME, megatech::ttt::open_mode::read_only };
+    assert(static_cast<std::uint32_t>(g.state()) == expected);
+  }
+  assert(std::filesystem::last_write_time(GAME_FILE_NAME) != old_time);
+  std::filesystem::remove_all(GAME_FILE_NAME);
+}
+
+void test_in_place_update() {
+  constexpr const char TRAILER[]{ "trailer" };
+  constexpr const char LINK_FILE_NAME[]{ ".ttt.link" };
+  // Only aligned version 2 records are updated in place. Version 1 files are always replaced.
+  for (const auto version :
+       { megatech::ttt::details::DATA_FILE_VERSION_1, megatech::ttt::details::DATA_FILE_VERSION_2 })
+  {
+    const auto id = std::uint32_t{ version == megatech::ttt::details::DATA_FILE_VERSION_2 };
+    std::filesystem::remove_all(GAME_FILE_NAME);
+    std::filesystem::remove_all(LINK_FILE_NAME);
+    if (version == megatech::ttt::details::DATA_FILE_VERSION_2)
+    {
+      megatech::ttt::create_game_table(GAME_FILE_NAME, 2, megatech::ttt::game_mode::multiplayer);
+    }
+    else
+    {
+      auto g = megatech::ttt::game{ GAME_FILE_NAME, megatech::ttt::game_mode::multiplayer };
+    }
+    {
+      auto f_out = std::ofstream{ GAME_FILE_NAME, std::ios::binary | std::ios::app };
+      f_out.write(TRAILER, sizeof(TRAILER));
+    }
+    // A hard link keeps the original file reachable after a replacement.
+    std::filesystem::create_hard_link(GAME_FILE_NAME, LINK_FILE_NAME);
+    const auto size = std::filesystem::file_size(GAME_FILE_NAME);
+    auto expected = std::uint32_t{ };
+    {
+      auto g = megatech::ttt::game{ GAME_FILE_NAME, id, megatech::ttt::open_mode::read_write };
+      g.synchronization(megatech::ttt::sync_policy::full);
+      g.take_turn(2, 2);
+      expected = static_cast<std::uint32_t>(g.state());
+    }
+    {
+      auto g = megatech::ttt::game{ GAME_FILE_NAME, id, megatech::ttt::open_mode::read_only };
+      assert(static_cast<std::uint32_t>(g.state()) == expected);
+    }
+    const auto in_place = megatech::ttt::details::mapped_file::is_available() &&
+                          version == megatech::ttt::details::DATA_FILE_VERSION_2;
+    {
+      auto g = megatech::ttt::game{ LINK_FILE_NAME, id, megatech::ttt::open_mode::read_only };
+      assert((static_cast<std::uint32_t>(g.state()) == expected) == in_place);
+    }
+    // Anything after the body survives an in-place update and a version 2 replacement.
+    if (version == megatech::ttt::details::DATA_FILE_VERSION_2)
+    {
+      assert(std::filesystem::file_size(GAME_FILE_NAME) == size);
+      auto f_in = std::ifstream{ GAME_FILE_NAME, std::ios::binary };
+      f_in.seekg(size - sizeof(TRAILER));
+      char trailer[sizeof(TRAILER)]{ };
+      f_in.read(trailer, sizeof(TRAILER));
+      assert(std::memcmp(trailer, TRAILER, sizeof(TRAILER)) == 0);
+    }
+    else
+    {
+      assert(std::filesystem::file_size(GAME_FILE_NAME) == sizeof(megatech::ttt::details::data_file_header) +
+                                                           sizeof(megatech::ttt::details::data_file_body_v1));
+    }
+    assert(!std::filesystem::exists(TEMPORARY_FILE_NAME));
+  }
+  std::filesystem::remove_all(LINK_FILE_NAME);
+  std::filesystem::remove_all(GAME_FILE_NAME);
+}
+
+std::uint32_t read_word(const std::size_t offset) {
+  auto f_in = std::ifstream{ GAME_FILE_NAME, std::ios::binary };
+  f_in.seekg(offset);
+  auto res = std::uint32_t{ };
+  f_in.read(reinterpret_cast<char*>(&res), sizeof(std::uint32_t));
+  return res;
+}
+
+void write_word(const std::size_t offset, const std::uint32_t value) {
+  auto f_out = std::fstream{ GAME_FILE_NAME, std::ios::binary | std::ios::in | std::ios::out };
+  f_out.seekp(offset);
+  f_out.write(reinterpret_cast<const char*>(&value), sizeof(std::uint32_t));
+}
+
+void test_game_table() {
+  constexpr const auto COUNT = std::uint32_t{ 100 };
+  constexpr const auto MULTIPLAYER = static_cast<std::uint32_t>(megatech::ttt::game_mode::multiplayer);
+  std::filesystem::remove_all(GAME_FILE_NAME);
+  megatech::ttt::create_game_table(GAME_FILE_NAME, COUNT, megatech::ttt::game_mode::multiplayer);
+  assert(std::filesystem::file_size(GAME_FILE_NAME) == megatech::ttt::details::data_file_record_v2_offset(COUNT));
+  assert(read_word(megatech::ttt::details::DATA_FILE_BODY_V2_OFFSET) ==
+         megatech::ttt::details::DATA_FILE_CORRECT_ENDIANNESS);
+  auto expected = std::uint32_t{ };
+  {
+    auto g = megatech::ttt::game{ GAME_FILE_NAME, 42, megatech::ttt::open_mode::read_write };
+    assert(g.id() == 42);
+    g.take_turn(1, 1);
+    expected = static_cast<std::uint32_t>(g.state());
+  }
+  assert(expected != MULTIPLAYER);
+  assert(std::filesystem::file_size(GAME_FILE_NAME) == megatech::ttt::details::data_file_record_v2_offset(COUNT));
+  for (auto id = std::uint32_t{ 0 }; id < COUNT; ++id)
+  {
+    auto g = megatech::ttt::game{ GAME_FILE_NAME, id, megatech::ttt::open_mode::read_only };
+    assert(static_cast<std::uint32_t>(g.state()) == (id == 42 ? expected : MULTIPLAYER));
+  }
+  {
+    auto g = megatech::ttt::game{ GAME_FILE_NAME, megatech::ttt::open_mode::read_only };
+    assert(g.id() == 0);
+    assert(static_cast<std::uint32_t>(g.state()) == MULTIPLAYER);
+  }
+  try
+  {
+    auto g = megatech::ttt::game{ GAME_FILE_NAME, COUNT, megatech::ttt::open_mode::read_only };
+    assert(false);
+  }
+  catch (const std::runtime_error&) { }
+  // Starting a new game only replaces a single record.
+  {
+    auto g = megatech::ttt::game{ GAME_FILE_NAME, 43, megatech::ttt::game_mode::single_player };
+  }
+  assert(static_cast<std::uint32_t>(megatech::ttt::game{ GAME_FILE_NAME, 42,
+                                                         megatech::ttt::open_mode::read_only }.state()) == expected);
+  assert(static_cast<std::uint32_t>(megatech::ttt::game{ GAME_FILE_NAME, 43,
+                                                         megatech::ttt::open_mode::read_only }.state()) == 0);
+  // A table in the reversed byte order is rewritten in the system byte order when any game in it is changed.
+  for (auto offset = megatech::ttt::details::DATA_FILE_BODY_V2_OFFSET;
+       offset < megatech::ttt::details::data_file_record_v2_offset(COUNT); offset += sizeof(std::uint32_t))
+  {
+    const auto value = read_word(offset);
+    write_word(offset, (value >> 24) | ((value >> 8) & 0xff'00) | ((value << 8) & 0xff'00'00) | (value << 24));
+  }
+  assert(read_word(megatech::ttt::details::DATA_FILE_BODY_V2_OFFSET) ==
+         megatech::ttt::details::DATA_FILE_REVERSE_ENDIANNESS);
+  {
+    auto g = megatech::ttt::game{ GAME_FILE_NAME, 42, megatech::ttt::open_mode::read_write };
+    assert(static_cast<std::uint32_t>(g.state()) == expected);
+    g.take_turn(0, 0);
+    expected = static_cast<std::uint32_t>(g.state());
+  }
+  assert(read_word(megatech::ttt::details::DATA_FILE_BODY_V2_OFFSET) ==
+         megatech::ttt::details::DATA_FILE_CORRECT_ENDIANNESS);
+  assert(read_word(megatech::ttt::details::DATA_FILE_BODY_V2_OFFSET + sizeof(std::uint32_t)) == COUNT);
+  assert(read_word(megatech::ttt::details::data_file_record_v2_offset(41)) == 41);
+  assert(read_word(megatech::ttt::details::data_file_record_v2_offset(41) + sizeof(std::uint32_t)) == MULTIPLAYER);
+  assert(read_word(megatech::ttt::details::data_file_record_v2_offset(42) + sizeof(std::uint32_t)) == expected);
+  // Records must be stored in ID order.
+  write_word(megatech::ttt::details::data_file_record_v2_offset(7), 8);
+  try
+  {
+    auto g = megatech::ttt::game{ GAME_FILE_NAME, 7, megatech::ttt::open_mode::read_only };
+    assert(false);
+  }
+  catch (const std::runtime_error&) { }
+  // The padding after the header must be zeroed.
+  {
+    auto f_out = std::fstream{ GAME_FILE_NAME, std::ios::binary | std::ios::in | std::ios::out };
+    f_out.seekp(megatech::ttt::details::DATA_FILE_BODY_V2_OFFSET - 1);
+    f_out.put('\x01');
+  }
+  try
+  {
+    auto g = megatech::ttt::game{ GAME_FILE_NAME, 0, megatech::ttt::open_mode::read_only };
+    assert(false);
+  }
+  catch (const std::runtime_error&) { }
+  {
+    auto f_out = std::fstream{ GAME_FILE_NAME, std::ios::binary | std::ios::in | std::ios::out };
+    f_out.seekp(megatech::ttt::details::DATA_FILE_BODY_V2_OFFSET - 1);
+    f_out.put('\x00');
+  }
+  {
+    auto g = megatech::ttt::game{ GAME_FILE_NAME, 0, megatech::ttt::open_mode::read_only };
+    assert(g.id() == 0);
+  }
+  // Truncated tables are invalid.
+  std::filesystem::resize_file(GAME_FILE_NAME, megatech::ttt::details::data_file_record_v2_offset(COUNT) - 1);
+  try
+  {
+    auto g = megatech::ttt::game{ GAME_FILE_NAME, 0, megatech::ttt::open_mode::read_only };
+    assert(false);
+  }
+  catch (const std::runtime_error&) { }
+  // Version 1 files and new files only hold a game with ID 0.
+  std::filesystem::remove_all(GAME_FILE_NAME);
+  try
+  {
+    auto g = megatech::ttt::game{ GAME_FILE_NAME, 1, megatech::ttt::game_mode::single_player };
+    assert(false);
+  }
+  catch (const std::runtime_error&) { }
+  {
+    auto g = megatech::ttt::game{ GAME_FILE_NAME, 0, megatech::ttt::game_mode::single_player };
+  }
+  try
+  {
+    auto g = megatech::ttt::game{ GAME_FILE_NAME, 1, megatech::ttt::open_mode::read_only };
+    assert(false);
+  }
+  catch (const std::runtime_error&) { }
+  std::filesystem::remove_all(GAME_FILE_NAME);
+}
+
 int main() {
   try
   {
@@ -172,6 +457,10 @@ int main() {
     test_existing_file_read_write();
     test_corrupt_file_header();
     test_state_byteswapping();
+    test_read_only();
+    test_write_back();
+    test_in_place_update();
+    test_game_table();
   }
   catch (...)
   {
@@ -0,0 +1,185 @@
+/**
+ * @file game_state.cpp
+ * @brief Game state query test.
+ * @author Alexander Rothman <gnomesort@megate.ch>
+ * @date 2024
+ * @copyright AGPL-3.0+
+ */
+#include <cassert>
+#include <cstddef>
+#include <cinttypes>
+
+#include <array>
+#include <set>
+
+#include <megatech/ttt/enums.hpp>
+#include <megatech/ttt/details/state.hpp>
+
+#include "test_states.hpp"
+
+megatech::ttt::cell_contents slow_winner(const megatech::ttt::details::state& st) {
+  for (auto i = std::size_t{ 0 }; i < 3; ++i)
+  {
+    if (st.is_row_x(i) || st.is_column_x(i))
+    {
+      return megatech::ttt::cell_contents::x;
+    }
+  }
+  if (st.is_left_diagonal_x() || st.is_right_diagonal_x())
+  {
+    return megatech::ttt::cell_contents::x;
+  }
+  for (auto i = std::size_t{ 0 }; i < 3; ++i)
+  {
+    if (st.is_row_o(i) || st.is_column_o(i))
+    {
+      return megatech::ttt::cell_contents::o;
+    }
+  }
+  if (st.is_left_diagonal_o() || st.is_right_diagonal_o())
+  {
+    return megatech::ttt::cell_contents::o;
+  }
+  return megatech::ttt::cell_contents::empty;
+}
+
+void test_winner() {
+  // Every possible board (including unreachable ones) is checked against the individual line queries.
+  for (auto i = std::size_t{ 0 }; i < 19'683; ++i)
+  {
+    auto st = state_from_index(i);
+    assert(st.winner() == slow_winner(st));
+    // The mode and phase bits must never influence the result.
+    st.mode(megatech::ttt::game_mode::multiplayer);
+    st.phase(megatech::ttt::game_phase::draw);
+    assert(st.winner() == slow_winner(st));
+  }
+}
+
+void test_completes_line() {
+  for (auto i = std::size_t{ 0 }; i < 19'683; ++i)
+  {
+    const auto st = state_from_index(i);
+    // Boards that already contain a complete line would be reported as won regardless of the next mark.
+    if (st.winner() != megatech::ttt::cell_contents::empty)
+    {
+      continue;
+    }
+    for (auto cell = std::size_t{ 0 }; cell < 9; ++cell)
+    {
+      for (const auto value : { megatech::ttt::cell_contents::x, megatech::ttt::cell_contents::o })
+      {
+        auto next = st;
+        next.cell(cell % 3, cell / 3, value);
+        assert(st.completes_line(cell % 3, cell / 3, value) == (next.winner() == value));
+        assert(next.completes_line(cell % 3, cell / 3, value) == (next.winner() == value));
+      }
+      assert(!st.completes_line(cell % 3, cell / 3, megatech::ttt::cell_contents::empty));
+    }
+  }
+  try
+  {
+    state_from_index(0).completes_line(3, 0, megatech::ttt::cell_contents::x);
+    assert(false);
+  }
+  catch (...) { }
+}
+
+void test_cell_sets() {
+  for (auto i = std::size_t{ 0 }; i < 19'683; ++i)
+  {
+    const auto st = state_from_index(i);
+    const auto empty = st.empty_cells();
+    const auto x = st.x_cells();
+    const auto o = st.o_cells();
+    assert(empty.size() + st.filled_cells() == 9);
+    assert(x.size() == st.count_x());
+    assert(o.size() == st.count_o());
+    for (auto cell = std::size_t{ 0 }; cell < 9; ++cell)
+    {
+      assert(empty.contains(cell) == (st.cell(cell % 3, cell / 3) == megatech::ttt::cell_contents::empty));
+      assert(x.contains(cell) == (st.cell(cell % 3, cell / 3) == megatech::ttt::cell_contents::x));
+      assert(o.contains(cell) == (st.cell(cell % 3, cell / 3) == megatech::ttt::cell_contents::o));
+    }
+    // Iteration must visit exactly the members of the set in ascending order.
+    auto visited = megatech::ttt::details::cell_set{ };
+    auto last = std::size_t{ 0 };
+    for (const auto cell : empty)
+    {
+      assert(visited.empty() || cell > last);
+      visited.insert(cell);
+      last = cell;
+    }
+    assert(static_cast<std::uint32_t>(visited) == static_cast<std::uint32_t>(empty));
+  }
+}
+
+constexpr std::array<megatech::ttt::details::symmetry, 8> ALL_SYMMETRIES{
+  megatech::ttt::details::symmetry::identity, megatech::ttt::details::symmetry::rotate_90,
+  megatech::ttt::details::symmetry::rotate_180, megatech::ttt::details::symmetry::rotate_270,
+  megatech::ttt::details::symmetry::reflect_horizontal, megatech::ttt::details::symmetry::reflect_vertical,
+  megatech::ttt::details::symmetry::reflect_left_diagonal, megatech::ttt::details::symmetry::reflect_right_diagonal
+};
+
+void test_symmetries() {
+  for (auto i = std::size_t{ 0 }; i < 19'683; ++i)
+  {
+    auto st = state_from_index(i);
+    st.mode(megatech::ttt::game_mode::multiplayer);
+    st.phase(megatech::ttt::game_phase::turn_o);
+    const auto [canonical, canonical_sym] = st.canonical();
+    assert(static_cast<std::uint32_t>(st.transformed(canonical_sym)) == static_cast<std::uint32_t>(canonical));
+    for (const auto sym : ALL_SYMMETRIES)
+    {
+      const auto next = st.transformed(sym);
+      assert(next.mode() == st.mode());
+      assert(next.phase() == st.phase());
+      assert(next.winner() == st.winner());
+      for (auto cell = std::size_t{ 0 }; cell < 9; ++cell)
+      {
+        const auto moved = megatech::ttt::details::transform_cell(sym, cell);
+        assert(next.cell(moved % 3, moved / 3) == st.cell(cell % 3, cell / 3));
+        assert(megatech::ttt::details::transform_cell(megatech::ttt::details::inverse(sym), moved) == cell);
+      }
+      // Every member of a symmetry class shares the same canonical form.
+      assert(static_cast<std::uint32_t>(next.canonical().first) == static_cast<std::uint32_t>(canonical));
+      assert(static_cast<std::uint32_t>(next.transformed(megatech::ttt::details::inverse(sym))) ==
+             static_cast<std::uint32_t>(st));
+    }
+  }
+  // There are 765 essentially different positions in Tic-Tac-Toe.
+  auto boards = std::set<std::uint32_t>{ };
+  visit_reachable([&boards](const megatech::ttt::details::state& st, const megatech::ttt::cell_contents) {
+    boards.insert(st.canonical().first.board());
+  });
+  assert(boards.size() == 765);
+}
+
+void test_cell_accessors() {
+  for (auto i = std::size_t{ 0 }; i < 19'683; ++i)
+  {
+    const auto st = state_from_index(i);
+    for (auto cell = std::size_t{ 0 }; cell < 9; ++cell)
+    {
+      assert(st.unchecked_cell(cell % 3, cell / 3) == st.cell(cell % 3, cell / 3));
+    }
+    assert((st.cell<0, 0>() == st.cell(0, 0)));
+    assert((st.cell<1, 0>() == st.cell(1, 0)));
+    assert((st.cell<2, 0>() == st.cell(2, 0)));
+    assert((st.cell<0, 1>() == st.cell(0, 1)));
+    assert((st.cell<1, 1>() == st.cell(1, 1)));
+    assert((st.cell<2, 1>() == st.cell(2, 1)));
+    assert((st.cell<0, 2>() == st.cell(0, 2)));
+    assert((st.cell<1, 2>() == st.cell(1, 2)));
+    assert((st.cell<2, 2>() == st.cell(2, 2)));
+  }
+}
+
+int main() {
+  test_cell_accessors();
+  test_winner();
+  test_completes_line();
+  test_cell_sets();
+  test_symmetries();
+  return 0;
+}
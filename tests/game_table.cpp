@@ -0,0 +1,267 @@
+/**
+ * @file game_table.cpp
+ * @brief Shared game table test.
+ * @author Alexander Rothman <gnomesort@megate.ch>
+ * @date 2024
+ * @copyright AGPL-3.0+
+ */
+#include <cassert>
+#include <cstddef>
+#include <cinttypes>
+
+#include <array>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <megatech/ttt/enums.hpp>
+#include <megatech/ttt/game.hpp>
+#include <megatech/ttt/game_table.hpp>
+#include <megatech/ttt/details/data_file.hpp>
+#include <megatech/ttt/details/lockfile.hpp>
+#include <megatech/ttt/details/validation.hpp>
+
+#define GAME_FILE_NAME ".ttt"
+
+constexpr const auto GAME_COUNT = std::uint32_t{ 256 };
+
+void test_concurrent_play() {
+  constexpr const auto THREAD_COUNT = std::size_t{ 4 };
+  constexpr const auto ROUNDS = std::size_t{ 8 };
+  std::filesystem::remove_all(GAME_FILE_NAME);
+  megatech::ttt::create_game_table(GAME_FILE_NAME, GAME_COUNT, megatech::ttt::game_mode::multiplayer);
+  auto turns = std::atomic<std::size_t>{ 0 };
+  {
+    auto threads = std::vector<std::jthread>{ };
+    for (auto t = std::size_t{ 0 }; t < THREAD_COUNT; ++t)
+    {
+      // Each thread maps the file separately just like separate processes would. Half of the threads play X and the
+      // other half play O.
+      threads.emplace_back([t, &turns]() {
+        const auto player = t % 2 ? megatech::ttt::cell_contents::o : megatech::ttt::cell_contents::x;
+        auto table = megatech::ttt::game_table{ GAME_FILE_NAME };
+        auto local = std::size_t{ 0 };
+        for (auto round = std::size_t{ 0 }; round < ROUNDS; ++round)
+        {
+          for (auto id = std::uint32_t{ 0 }; id < table.size(); ++id)
+          {
+            // Every thread tries every cell in a different order so that turns frequently collide.
+            const auto cell = (id * 7 + round * 5 + t * 3) % 9;
+            try
+            {
+              local += table.take_turn(id, player, cell % 3, cell / 3);
+            }
+            catch (const std::runtime_error&) { }
+          }
+        }
+        turns += local;
+      });
+    }
+  }
+  auto table = megatech::ttt::game_table{ GAME_FILE_NAME };
+  assert(table.size() == GAME_COUNT);
+  auto filled = std::size_t{ 0 };
+  for (auto id = std::uint32_t{ 0 }; id < GAME_COUNT; ++id)
+  {
+    const auto st = table.state(id);
+    assert(megatech::ttt::details::is_valid_state(static_cast<std::uint32_t>(st)));
+    assert(st.mode() == megatech::ttt::game_mode::multiplayer);
+    filled += st.filled_cells();
+    assert(st.count_x() == st.count_o() || st.count_x() == st.count_o() + 1);
+    // The table and game objects must agree on the contents of the file.
+    const auto g = megatech::ttt::game{ GAME_FILE_NAME, id, megatech::ttt::open_mode::read_only };
+    assert(static_cast<std::uint32_t>(g.state()) == static_cast<std::uint32_t>(st));
+  }
+  // No turn may be lost or duplicated.
+  assert(filled == turns);
+  table.flush(megatech::ttt::sync_policy::full);
+  std::filesystem::remove_all(GAME_FILE_NAME);
+}
+
+void test_racing_players() {
+  std::filesystem::remove_all(GAME_FILE_NAME);
+  megatech::ttt::create_game_table(GAME_FILE_NAME, GAME_COUNT, megatech::ttt::game_mode::multiplayer);
+  auto turns = std::atomic<std::size_t>{ 0 };
+  {
+    auto threads = std::vector<std::jthread>{ };
+    // Two callers both try to move for X in every game. Only one of them may succeed and neither may place an O.
+    for (const auto cell : { std::size_t{ 0 }, std::size_t{ 8 } })
+    {
+      threads.emplace_back([cell, &turns]() {
+        auto table = megatech::ttt::game_table{ GAME_FILE_NAME };
+        for (auto id = std::uint32_t{ 0 }; id < table.size(); ++id)
+        {
+          turns += table.take_turn(id, megatech::ttt::cell_contents::x, cell % 3, cell / 3);
+        }
+      });
+    }
+  }
+  assert(turns == GAME_COUNT);
+  auto table = megatech::ttt::game_table{ GAME_FILE_NAME };
+  for (auto id = std::uint32_t{ 0 }; id < GAME_COUNT; ++id)
+  {
+    const auto st = table.state(id);
+    assert(st.count_x() == 1);
+    assert(st.count_o() == 0);
+    assert(st.phase() == megatech::ttt::game_phase::turn_o);
+  }
+  std::filesystem::remove_all(GAME_FILE_NAME);
+}
+
+void test_turns() {
+  std::filesystem::remove_all(GAME_FILE_NAME);
+  megatech::ttt::create_game_table(GAME_FILE_NAME, GAME_COUNT, megatech::ttt::game_mode::single_player);
+  auto table = megatech::ttt::game_table{ GAME_FILE_NAME };
+  auto other = megatech::ttt::game_table{ GAME_FILE_NAME };
+  constexpr const auto X = megatech::ttt::cell_contents::x;
+  constexpr const auto O = megatech::ttt::cell_contents::o;
+  assert(table.take_turn(3, X, 0, 0));
+  assert(other.state(3).cell(0, 0) == megatech::ttt::cell_contents::x);
+  assert(other.state(3).phase() == megatech::ttt::game_phase::turn_o);
+  try
+  {
+    other.take_turn(3, O, 0, 0);
+    assert(false);
+  }
+  catch (const std::runtime_error&) { }
+  try
+  {
+    other.take_turn(3, megatech::ttt::cell_contents::empty, 1, 0);
+    assert(false);
+  }
+  catch (const std::runtime_error&) { }
+  // Turns are never taken out of order.
+  assert(!table.take_turn(3, X, 1, 0));
+  assert(other.state(3).filled_cells() == 1);
+  // X wins down the first column.
+  assert(other.take_turn(3, O, 1, 0));
+  assert(table.take_turn(3, X, 0, 1));
+  assert(other.take_turn(3, O, 1, 1));
+  assert(table.take_turn(3, X, 0, 2));
+  assert(table.state(3).phase() == megatech::ttt::game_phase::win_x);
+  assert(!other.take_turn(3, O, 2, 2));
+  assert(static_cast<std::uint32_t>(table.state(4)) == 0);
+  table.reset(3, megatech::ttt::game_mode::multiplayer);
+  assert(other.state(3).mode() == megatech::ttt::game_mode::multiplayer);
+  assert(other.state(3).filled_cells() == 0);
+  try
+  {
+    table.state(GAME_COUNT);
+    assert(false);
+  }
+  catch (const std::runtime_error&) { }
+  std::filesystem::remove_all(GAME_FILE_NAME);
+}
+
+void test_invalid_files() {
+  std::filesystem::remove_all(GAME_FILE_NAME);
+  try
+  {
+    auto table = megatech::ttt::game_table{ GAME_FILE_NAME };
+    assert(false);
+  }
+  catch (const std::runtime_error&) { }
+  // Files that hold a single game can't be shared.
+  {
+    auto g = megatech::ttt::game{ GAME_FILE_NAME, megatech::ttt::game_mode::single_player };
+  }
+  try
+  {
+    auto table = megatech::ttt::game_table{ GAME_FILE_NAME };
+    assert(false);
+  }
+  catch (const std::runtime_error&) { }
+  // The padding after the header must be zeroed.
+  megatech::ttt::create_game_table(GAME_FILE_NAME, GAME_COUNT, megatech::ttt::game_mode::multiplayer);
+  {
+    auto file = std::fstream{ GAME_FILE_NAME, std::ios::binary | std::ios::in | std::ios::out };
+    file.seekp(megatech::ttt::details::DATA_FILE_BODY_V2_OFFSET - 1);
+    file.put('\x01');
+  }
+  try
+  {
+    auto table = megatech::ttt::game_table{ GAME_FILE_NAME };
+    assert(false);
+  }
+  catch (const std::runtime_error&) { }
+  std::filesystem::remove_all(GAME_FILE_NAME);
+}
+
+void reverse_byte_order(const std::uint32_t count) {
+  auto file = std::fstream{ GAME_FILE_NAME, std::ios::binary | std::ios::in | std::ios::out };
+  for (auto offset = megatech::ttt::details::DATA_FILE_BODY_V2_OFFSET;
+       offset < megatech::ttt::details::data_file_record_v2_offset(count); offset += sizeof(std::uint32_t))
+  {
+    auto bytes = std::array<char, sizeof(std::uint32_t)>{ };
+    file.seekg(offset);
+    file.read(bytes.data(), bytes.size());
+    std::swap(bytes[0], bytes[3]);
+    std::swap(bytes[1], bytes[2]);
+    file.seekp(offset);
+    file.write(bytes.data(), bytes.size());
+  }
+}
+
+void test_byte_order() {
+  // Empty tables are valid too.
+  for (const auto count : { GAME_COUNT, std::uint32_t{ 0 } })
+  {
+    std::filesystem::remove_all(GAME_FILE_NAME);
+    megatech::ttt::create_game_table(GAME_FILE_NAME, count, megatech::ttt::game_mode::multiplayer);
+    reverse_byte_order(count);
+    {
+      auto table = megatech::ttt::game_table{ GAME_FILE_NAME };
+      assert(table.size() == count);
+      for (auto id = std::uint32_t{ 0 }; id < count; ++id)
+      {
+        assert(table.state(id).mode() == megatech::ttt::game_mode::multiplayer);
+      }
+    }
+    // The file itself is rewritten in the system byte order.
+    auto body = megatech::ttt::details::data_file_body_v2{ };
+    {
+      auto f_in = std::ifstream{ GAME_FILE_NAME, std::ios::binary };
+      f_in.seekg(megatech::ttt::details::DATA_FILE_BODY_V2_OFFSET);
+      f_in.read(reinterpret_cast<char*>(&body), sizeof(body));
+    }
+    assert(body.endianness == megatech::ttt::details::DATA_FILE_CORRECT_ENDIANNESS);
+    assert(body.count == count);
+    assert(std::filesystem::file_size(GAME_FILE_NAME) == megatech::ttt::details::data_file_record_v2_offset(count));
+    assert(!std::filesystem::exists(".~new" GAME_FILE_NAME));
+    assert(!std::filesystem::exists(".~lock" GAME_FILE_NAME));
+  }
+  // Files that need to be rewritten can't be opened while they're locked.
+  reverse_byte_order(0);
+  {
+    auto lock = megatech::ttt::details::lockfile{ GAME_FILE_NAME };
+    lock.lock();
+    try
+    {
+      auto table = megatech::ttt::game_table{ GAME_FILE_NAME };
+      assert(false);
+    }
+    catch (const std::runtime_error&) { }
+  }
+  std::filesystem::remove_all(GAME_FILE_NAME);
+}
+
+int main() {
+  try
+  {
+    test_concurrent_play();
+    test_racing_players();
+    test_turns();
+    test_invalid_files();
+    test_byte_order();
+  }
+  catch (...)
+  {
+    std::filesystem::remove_all(GAME_FILE_NAME);
+    throw;
+  }
+  return 0;
+}
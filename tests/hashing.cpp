@@ -0,0 +1,84 @@
+/**
+ * @file hashing.cpp
+ * @brief Game state hashing test.
+ * @author Alexander Rothman <gnomesort@megate.ch>
+ * @date 2024
+ * @copyright AGPL-3.0+
+ */
+#include <cassert>
+#include <cstddef>
+#include <cinttypes>
+
+#include <array>
+#include <set>
+
+#include <megatech/ttt/enums.hpp>
+#include <megatech/ttt/details/state.hpp>
+#include <megatech/ttt/details/rank.hpp>
+
+// Compute the chi-squared statistic of the hashes of every reachable board distributed over BUCKETS buckets.
+template <std::size_t BUCKETS, typename Bucket>
+double chi_squared(Bucket&& bucket) {
+  auto counts = std::array<std::size_t, BUCKETS>{ };
+  for (auto r = std::size_t{ 0 }; r < megatech::ttt::details::REACHABLE_BOARD_COUNT; ++r)
+  {
+    ++counts[bucket(megatech::ttt::details::unrank(r).hash()) % BUCKETS];
+  }
+  const auto expected = static_cast<double>(megatech::ttt::details::REACHABLE_BOARD_COUNT) / BUCKETS;
+  auto res = 0.0;
+  for (const auto count : counts)
+  {
+    res += (count - expected) * (count - expected) / expected;
+  }
+  return res;
+}
+
+void test_incremental_hash() {
+  auto st = megatech::ttt::details::state{ };
+  assert(st.hash() == 0);
+  for (auto r = std::size_t{ 0 }; r < megatech::ttt::details::REACHABLE_BOARD_COUNT; ++r)
+  {
+    st = megatech::ttt::details::unrank(r);
+    // The hash maintained while marking cells must equal the hash computed from scratch.
+    const auto rebuilt = megatech::ttt::details::state{ static_cast<std::uint32_t>(st) };
+    assert(rebuilt.hash() == st.hash());
+    // Clearing every mark restores the hash of the empty board.
+    auto cleared = rebuilt;
+    for (auto cell = std::size_t{ 0 }; cell < 9; ++cell)
+    {
+      cleared.cell(cell % 3, cell / 3, megatech::ttt::cell_contents::empty);
+    }
+    assert(cleared.hash() == 0);
+    // The mode and phase never contribute.
+    cleared = st;
+    cleared.mode(megatech::ttt::game_mode::multiplayer);
+    cleared.phase(megatech::ttt::game_phase::draw);
+    assert(cleared.hash() == st.hash());
+    for (auto sym = std::uint32_t{ 0 }; sym < 8; ++sym)
+    {
+      const auto transformed = st.transformed(static_cast<megatech::ttt::details::symmetry>(sym));
+      assert(megatech::ttt::details::state{ static_cast<std::uint32_t>(transformed) }.hash() == transformed.hash());
+    }
+  }
+}
+
+void test_distribution() {
+  // No two reachable boards share a hash.
+  auto hashes = std::set<std::uint32_t>{ };
+  for (auto r = std::size_t{ 0 }; r < megatech::ttt::details::REACHABLE_BOARD_COUNT; ++r)
+  {
+    hashes.insert(megatech::ttt::details::unrank(r).hash());
+  }
+  assert(hashes.size() == megatech::ttt::details::REACHABLE_BOARD_COUNT);
+  // With 1,023 degrees of freedom the chi-squared statistic of a uniform distribution has a mean of 1,023 and a
+  // standard deviation of about 45. Both the low bits (used to index tables) and the high bits are checked.
+  constexpr auto LIMIT = 1'023.0 + 5 * 45.0;
+  assert(chi_squared<1'024>([](const std::uint32_t hash) { return hash; }) < LIMIT);
+  assert(chi_squared<1'024>([](const std::uint32_t hash) { return hash >> 22; }) < LIMIT);
+}
+
+int main() {
+  test_incremental_hash();
+  test_distribution();
+  return 0;
+}
@@ -0,0 +1,101 @@
+/**
+ * @file prng.cpp
+ * @brief Reproducible random number generation test.
+ * @author Alexander Rothman <gnomesort@megate.ch>
+ * @date 2024
+ * @copyright AGPL-3.0+
+ */
+#include <cassert>
+#include <cstddef>
+#include <cinttypes>
+
+#include <array>
+#include <random>
+
+#include <megatech/ttt/enums.hpp>
+#include <megatech/ttt/strategy.hpp>
+#include <megatech/ttt/details/prng.hpp>
+#include <megatech/ttt/details/state.hpp>
+
+static_assert(std::uniform_random_bit_generator<megatech::ttt::details::prng>);
+
+void test_known_answers() {
+  // Reference output of xoshiro256** seeded through splitmix64.
+  auto gen = megatech::ttt::details::prng{ 0 };
+  assert(gen() == 0x99'ec'5f'36'cb'75'f2'b4);
+  assert(gen() == 0xbf'6e'1f'78'49'56'45'2a);
+  assert(gen() == 0x1a'5f'84'9d'49'33'e6'e0);
+  assert(gen() == 0x6a'a5'94'f1'26'2d'2d'2c);
+  gen = megatech::ttt::details::prng{ 0x12'34 };
+  assert(gen() == 0xcf'13'50'dc'ca'3d'eb'e9);
+  assert(gen() == 0xac'c5'3b'3f'b4'6c'23'1f);
+}
+
+void test_bounded() {
+  auto gen = megatech::ttt::details::prng{ 42 };
+  assert(gen.below(0) == 0);
+  assert(gen.below(1) == 0);
+  for (const auto bound : { 2u, 3u, 5u, 8u, 9u })
+  {
+    auto counts = std::array<std::size_t, 9>{ };
+    constexpr auto samples = std::size_t{ 90'000 };
+    for (auto i = std::size_t{ 0 }; i < samples; ++i)
+    {
+      const auto value = gen.below(bound);
+      assert(value < bound);
+      ++counts[value];
+    }
+    // Each bucket should hold close to samples / bound values. The tolerance is far outside of normal variation.
+    for (auto i = std::size_t{ 0 }; i < bound; ++i)
+    {
+      assert(counts[i] > (samples / bound) * 9 / 10 && counts[i] < (samples / bound) * 11 / 10);
+    }
+  }
+}
+
+// Play out a game where X moves randomly and O uses the strategy. Returns the sequence of O's moves as base 9 digits.
+std::uint64_t play(const megatech::ttt::strategy& strat, megatech::ttt::details::prng& x_player) {
+  auto st = megatech::ttt::details::state{ };
+  auto res = std::uint64_t{ 0 };
+  while (st.winner() == megatech::ttt::cell_contents::empty && !st.is_board_full())
+  {
+    const auto empty = st.empty_cells();
+    auto it = empty.begin();
+    for (auto skip = x_player.below(empty.size()); skip > 0; --skip)
+    {
+      ++it;
+    }
+    const auto last = megatech::ttt::cell_location{ *it % 3, *it / 3 };
+    st.cell(last.column, last.row, megatech::ttt::cell_contents::x);
+    if (st.winner() != megatech::ttt::cell_contents::empty || st.is_board_full())
+    {
+      break;
+    }
+    const auto reply = strat.run(st, last);
+    st.cell(reply.column, reply.row, megatech::ttt::cell_contents::o);
+    res = res * 9 + reply.row * 3 + reply.column;
+  }
+  return res;
+}
+
+void test_reproducible_strategy(const megatech::ttt::strategy_algorithm algorithm) {
+  const auto first = megatech::ttt::strategy{ algorithm, 1'234 };
+  const auto second = megatech::ttt::strategy{ algorithm, 1'234 };
+  auto first_x = megatech::ttt::details::prng{ 99 };
+  auto second_x = megatech::ttt::details::prng{ 99 };
+  for (auto i = std::size_t{ 0 }; i < 1'000; ++i)
+  {
+    assert(play(first, first_x) == play(second, second_x));
+  }
+}
+
+int main() {
+  test_known_answers();
+  test_bounded();
+  test_reproducible_strategy(megatech::ttt::strategy_algorithm::heuristic);
+  test_reproducible_strategy(megatech::ttt::strategy_algorithm::negamax);
+  test_reproducible_strategy(megatech::ttt::strategy_algorithm::book);
+  const auto seeded = megatech::ttt::strategy{ std::uint64_t{ 7 } };
+  assert(seeded.algorithm() == megatech::ttt::strategy_algorithm::heuristic);
+  return 0;
+}
@@ -0,0 +1,82 @@
+/**
+ * @file ranking.cpp
+ * @brief Dense state indexing test.
+ * @author Alexander Rothman <gnomesort@megate.ch>
+ * @date 2024
+ * @copyright AGPL-3.0+
+ */
+#include <cassert>
+#include <cstddef>
+#include <cinttypes>
+
+#include <vector>
+
+#include <megatech/ttt/enums.hpp>
+#include <megatech/ttt/details/state.hpp>
+#include <megatech/ttt/details/rank.hpp>
+
+#include "test_states.hpp"
+
+void test_bijection() {
+  auto seen = std::vector<bool>(megatech::ttt::details::REACHABLE_BOARD_COUNT, false);
+  visit_reachable([&seen](const megatech::ttt::details::state& st, const megatech::ttt::cell_contents) {
+    const auto r = megatech::ttt::details::rank(st);
+    assert(r < megatech::ttt::details::REACHABLE_BOARD_COUNT);
+    seen[r] = true;
+  });
+  // Every rank is produced by some reachable board.
+  for (const auto s : seen)
+  {
+    assert(s);
+  }
+  auto last_index = std::size_t{ 0 };
+  for (auto r = std::size_t{ 0 }; r < megatech::ttt::details::REACHABLE_BOARD_COUNT; ++r)
+  {
+    const auto st = megatech::ttt::details::unrank(r);
+    assert(megatech::ttt::details::rank(st) == r);
+    // Ranks preserve the order of the base 3 board index.
+    const auto index = megatech::ttt::details::board_index(st);
+    assert(r == 0 || index > last_index);
+    last_index = index;
+  }
+}
+
+void test_unranked_phase() {
+  auto st = megatech::ttt::details::state{ };
+  assert(megatech::ttt::details::unrank(megatech::ttt::details::rank(st)).phase() ==
+         megatech::ttt::game_phase::turn_x);
+  st.cell(1, 1, megatech::ttt::cell_contents::x);
+  assert(megatech::ttt::details::unrank(megatech::ttt::details::rank(st)).phase() ==
+         megatech::ttt::game_phase::turn_o);
+  st.cell(0, 0, megatech::ttt::cell_contents::o);
+  st.cell(0, 1, megatech::ttt::cell_contents::x);
+  st.cell(1, 0, megatech::ttt::cell_contents::o);
+  st.cell(2, 1, megatech::ttt::cell_contents::x);
+  assert(megatech::ttt::details::unrank(megatech::ttt::details::rank(st)).phase() ==
+         megatech::ttt::game_phase::win_x);
+}
+
+void test_unreachable() {
+  // O can never have more marks than X.
+  auto st = megatech::ttt::details::state{ };
+  st.cell(0, 0, megatech::ttt::cell_contents::o);
+  try
+  {
+    megatech::ttt::details::rank(st);
+    assert(false);
+  }
+  catch (...) { }
+  try
+  {
+    megatech::ttt::details::unrank(megatech::ttt::details::REACHABLE_BOARD_COUNT);
+    assert(false);
+  }
+  catch (...) { }
+}
+
+int main() {
+  test_bijection();
+  test_unranked_phase();
+  test_unreachable();
+  return 0;
+}
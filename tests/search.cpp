@@ -0,0 +1,147 @@
+/**
+ * @file search.cpp
+ * @brief Bounded iterative deepening search test.
+ * @author Alexander Rothman <gnomesort@megate.ch>
+ * @date 2024
+ * @copyright AGPL-3.0+
+ */
+#include <cassert>
+#include <cstddef>
+#include <cinttypes>
+
+#include <chrono>
+#include <stdexcept>
+
+#include <megatech/ttt/enums.hpp>
+#include <megatech/ttt/strategy.hpp>
+#include <megatech/ttt/details/basic_state.hpp>
+#include <megatech/ttt/details/rank.hpp>
+#include <megatech/ttt/details/search.hpp>
+#include <megatech/ttt/details/solver.hpp>
+#include <megatech/ttt/details/state.hpp>
+
+using namespace std::chrono_literals;
+
+using standard_search = megatech::ttt::details::iterative_search<megatech::ttt::details::state>;
+
+// With an unbounded budget the search must agree with the solver on every position that can occur in a game.
+void test_matches_solver() {
+  auto search = standard_search{ };
+  auto solver = megatech::ttt::details::solver{ };
+  for (auto r = std::size_t{ 0 }; r < megatech::ttt::details::REACHABLE_BOARD_COUNT; ++r)
+  {
+    const auto st = megatech::ttt::details::unrank(r);
+    if (st.winner() != megatech::ttt::cell_contents::empty || st.is_board_full())
+    {
+      continue;
+    }
+    const auto expected = solver.evaluate(st);
+    const auto res = search.run(st, 1h);
+    assert(res.complete);
+    assert(res.nodes > 0);
+    assert(st.empty_cells().contains(res.move));
+    // Both searches score a win made with n marks on the board as a constant minus n.
+    if (expected > 0)
+    {
+      assert(res.score == expected - 10 + standard_search::WIN_SCORE);
+    }
+    else if (expected < 0)
+    {
+      assert(res.score == expected + 10 - standard_search::WIN_SCORE);
+    }
+    else
+    {
+      assert(res.score == 0);
+    }
+  }
+}
+
+void test_node_limit() {
+  using board = megatech::ttt::details::basic_state<7, 6, 4>;
+  auto search = megatech::ttt::details::iterative_search<board>{ };
+  auto st = board{ };
+  st.cell(3, 5, megatech::ttt::cell_contents::x);
+  // The first ply always completes so a legal move is found no matter how small the limit is.
+  auto res = search.run(st, 1h, 1);
+  assert(!res.complete);
+  assert(res.depth == 1);
+  assert(st.empty_cells().contains(res.move));
+  res = search.run(st, 1h, 10'000);
+  assert(!res.complete);
+  assert(res.depth > 1);
+  assert(res.nodes <= 10'000 + board::CELLS);
+}
+
+void test_deadline() {
+  using board = megatech::ttt::details::basic_state<15, 15, 5>;
+  auto search = megatech::ttt::details::iterative_search<board>{ };
+  auto st = board{ };
+  st.cell(7, 7, megatech::ttt::cell_contents::x);
+  const auto start = std::chrono::steady_clock::now();
+  const auto res = search.run(st, 20ms);
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  assert(!res.complete);
+  assert(st.empty_cells().contains(res.move));
+  // The deadline is checked periodically so allow some slack.
+  assert(elapsed < 1s);
+}
+
+void test_finds_forced_results() {
+  using board = megatech::ttt::details::basic_state<4, 4, 4>;
+  auto search = megatech::ttt::details::iterative_search<board>{ };
+  auto st = board{ };
+  // X to move can complete the second row.
+  st.cell(0, 1, megatech::ttt::cell_contents::x);
+  st.cell(1, 1, megatech::ttt::cell_contents::x);
+  st.cell(2, 1, megatech::ttt::cell_contents::x);
+  st.cell(0, 3, megatech::ttt::cell_contents::o);
+  st.cell(2, 3, megatech::ttt::cell_contents::o);
+  st.cell(3, 2, megatech::ttt::cell_contents::o);
+  auto res = search.run(st, 1h);
+  assert(res.complete);
+  assert(res.move == 1 * board::COLUMNS + 3);
+  assert(res.score == megatech::ttt::details::iterative_search<board>::WIN_SCORE - 6);
+  // With O to move instead, the only move that doesn't lose immediately is the block.
+  st.cell(3, 2, megatech::ttt::cell_contents::empty);
+  res = search.run(st, 1h, 100'000);
+  assert(res.move == 1 * board::COLUMNS + 3);
+}
+
+void test_finished_game() {
+  auto search = standard_search{ };
+  auto st = megatech::ttt::details::state{ };
+  st.cell(0, 0, megatech::ttt::cell_contents::x);
+  st.cell(1, 0, megatech::ttt::cell_contents::x);
+  st.cell(2, 0, megatech::ttt::cell_contents::x);
+  try
+  {
+    search.run(st, 1h);
+    assert(false);
+  }
+  catch (const std::runtime_error&) { }
+}
+
+void test_strategy_budget() {
+  // A budget that is large enough to finish the search always finds an optimal move.
+  auto strat = megatech::ttt::strategy{ megatech::ttt::strategy_algorithm::negamax, 0 };
+  auto solver = megatech::ttt::details::solver{ };
+  auto st = megatech::ttt::details::state{ };
+  st.cell(0, 0, megatech::ttt::cell_contents::x);
+  const auto location = strat.run(st, { 0, 0 }, 1h);
+  auto next = st;
+  next.cell(location.column, location.row, megatech::ttt::cell_contents::o);
+  assert(solver.evaluate(next) == 0);
+  // Even with no time at all a legal move is returned.
+  const auto rushed = strat.run(st, { 0, 0 }, 0ns);
+  assert(st.is_cell_empty(rushed.column, rushed.row));
+}
+
+int main() {
+  test_matches_solver();
+  test_node_limit();
+  test_deadline();
+  test_finds_forced_results();
+  test_finished_game();
+  test_strategy_budget();
+  return 0;
+}
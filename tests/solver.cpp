@@ -0,0 +1,85 @@
+/**
+ * @file solver.cpp
+ * @brief Perfect play solver test.
+ * @author Alexander Rothman <gnomesort@megate.ch>
+ * @date 2024
+ * @copyright AGPL-3.0+
+ */
+#include <cassert>
+#include <cstddef>
+
+#include <megatech/ttt/enums.hpp>
+#include <megatech/ttt/details/state.hpp>
+#include <megatech/ttt/details/solver.hpp>
+
+// Play every possible sequence of X moves against the solver's choices for O. Returns the number of games played.
+std::size_t play_all(megatech::ttt::details::solver& s, const megatech::ttt::details::state& st) {
+  auto games = std::size_t{ 0 };
+  for (const auto x : st.empty_cells())
+  {
+    auto next = st;
+    next.cell(x % 3, x / 3, megatech::ttt::cell_contents::x);
+    // O must never lose.
+    assert(next.winner() != megatech::ttt::cell_contents::x);
+    if (next.is_board_full())
+    {
+      ++games;
+      continue;
+    }
+    const auto o = s.best_move(next);
+    assert(next.is_cell_empty(o % 3, o / 3));
+    next.cell(o % 3, o / 3, megatech::ttt::cell_contents::o);
+    if (next.winner() == megatech::ttt::cell_contents::o)
+    {
+      ++games;
+      continue;
+    }
+    games += play_all(s, next);
+  }
+  return games;
+}
+
+void test_values() {
+  auto s = megatech::ttt::details::solver{ };
+  auto st = megatech::ttt::details::state{ };
+  // Perfect play from the empty board is a draw.
+  assert(s.evaluate(st) == 0);
+  // X can force a win when O answers a corner opening with an adjacent edge.
+  st.cell(0, 0, megatech::ttt::cell_contents::x);
+  st.cell(1, 0, megatech::ttt::cell_contents::o);
+  assert(s.evaluate(st) > 0);
+  // O wins immediately when it has two in a row and it is O's turn.
+  st = megatech::ttt::details::state{ };
+  st.cell(0, 0, megatech::ttt::cell_contents::o);
+  st.cell(1, 0, megatech::ttt::cell_contents::o);
+  st.cell(0, 1, megatech::ttt::cell_contents::x);
+  st.cell(1, 1, megatech::ttt::cell_contents::x);
+  st.cell(2, 2, megatech::ttt::cell_contents::x);
+  assert(s.best_move(st) == 2);
+  assert(s.evaluate(st) == 10 - 5);
+  try
+  {
+    st.cell(2, 0, megatech::ttt::cell_contents::o);
+    s.best_move(st);
+    assert(false);
+  }
+  catch (...) { }
+}
+
+void test_never_loses() {
+  auto s = megatech::ttt::details::solver{ };
+  auto games = play_all(s, megatech::ttt::details::state{ });
+  assert(games > 0);
+  // Every position reachable by X is solved at most once thanks to the transposition table. There are only 5,478
+  // legal positions so the search must stay well below that number of nodes per position visited.
+  const auto nodes = s.nodes();
+  s.clear();
+  assert(s.nodes() == 0);
+  assert(nodes < 20'000);
+}
+
+int main() {
+  test_values();
+  test_never_loses();
+  return 0;
+}
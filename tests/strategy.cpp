@@ -6,10 +6,16 @@
  * @copyright AGPL-3.0+
  */
 #include <cassert>
+#include <cstddef>
+#include <cinttypes>
 
 #include <megatech/ttt/enums.hpp>
 #include <megatech/ttt/strategy.hpp>
+#include <megatech/ttt/details/cell_set.hpp>
 #include <megatech/ttt/details/state.hpp>
+#include <megatech/ttt/details/forks.hpp>
+
+#include "test_states.hpp"
 
 megatech::ttt::details::state initialized_state() {
   auto st = megatech::ttt::details::state{ };
@@ -25,10 +31,10 @@ bool is_center(const megatech::ttt::cell_location& location) {
   return location.column == 1 && location.row == 1;
 }
 
-void test_openings() {
+void test_openings(const megatech::ttt::strategy_algorithm algorithm) {
   auto st = initialized_state();
   st.cell(0, 0, megatech::ttt::cell_contents::x);
-  auto strat = megatech::ttt::strategy{ };
+  auto strat = megatech::ttt::strategy{ algorithm };
   auto res = strat(st, { 0, 0 });
   assert(is_center(res));
   st = initialized_state();
@@ -38,10 +44,12 @@ void test_openings() {
   st = initialized_state();
   st.cell(1, 0, megatech::ttt::cell_contents::x);
   res = strat(st, { 1, 0 });
-  assert(is_center(res) || is_corner(res));
+  // The opposite edge is an equally good reply to an edge opening. Only the book ever selects it.
+  assert(is_center(res) || is_corner(res) ||
+         (algorithm == megatech::ttt::strategy_algorithm::book && res.column == 1 && res.row == 2));
 }
 
-void test_win() {
+void test_win(const megatech::ttt::strategy_algorithm algorithm) {
   // Win on a row
   auto st = initialized_state();
   st.cell(1, 1, megatech::ttt::cell_contents::x);
@@ -49,7 +57,7 @@ void test_win() {
   st.cell(2, 2, megatech::ttt::cell_contents::x);
   st.cell(1, 0, megatech::ttt::cell_contents::o);
   st.cell(1, 2, megatech::ttt::cell_contents::x);
-  auto strat = megatech::ttt::strategy{ };
+  auto strat = megatech::ttt::strategy{ algorithm };
   auto res = strat(st, { 1, 2 });
   assert(res.column == 2 && res.row == 0);
   // Win on a column
@@ -72,13 +80,13 @@ void test_win() {
   assert(res.column == 0 && res.row == 2);
 }
 
-void test_block() {
+void test_block(const megatech::ttt::strategy_algorithm algorithm) {
   // Block on a row
   auto st = initialized_state();
   st.cell(0, 0, megatech::ttt::cell_contents::x);
   st.cell(1, 1, megatech::ttt::cell_contents::o);
   st.cell(1, 0, megatech::ttt::cell_contents::x);
-  auto strat = megatech::ttt::strategy{ };
+  auto strat = megatech::ttt::strategy{ algorithm };
   auto res = strat(st, { 1, 0 });
   assert(res.column == 2 && res.row == 0);
   // Block on a column
@@ -97,20 +105,95 @@ void test_block() {
   assert(res.column == 0 && res.row == 2);
 }
 
-void test_fork_block() {
+void test_fork_block(const megatech::ttt::strategy_algorithm algorithm) {
   auto st = initialized_state();
   st.cell(0, 0, megatech::ttt::cell_contents::x);
   st.cell(1, 1, megatech::ttt::cell_contents::o);
   st.cell(2, 2, megatech::ttt::cell_contents::x);
-  auto strat = megatech::ttt::strategy{ };
+  auto strat = megatech::ttt::strategy{ algorithm };
   auto res = strat(st, { 2, 2 });
   assert(!is_corner(res));
 }
 
+void test_fork_regression(const megatech::ttt::strategy_algorithm algorithm) {
+  // With the fork check gated on 3 and 6 marks instead of 3 and 5, the heuristic could lose with the line
+  // 8 4 1 5 3 2 6 0 7. Marking 2 after the fifth mark lets X fork with 6.
+  auto st = initialized_state();
+  st.cell(2, 2, megatech::ttt::cell_contents::x);
+  st.cell(1, 1, megatech::ttt::cell_contents::o);
+  st.cell(1, 0, megatech::ttt::cell_contents::x);
+  st.cell(2, 1, megatech::ttt::cell_contents::o);
+  st.cell(0, 1, megatech::ttt::cell_contents::x);
+  auto strat = megatech::ttt::strategy{ algorithm };
+  const auto moves = strat.candidates(st, { 0, 1 });
+  assert(!moves.empty());
+  assert(!moves.contains(2));
+  for (auto i = 0; i < 32; ++i)
+  {
+    const auto res = strat(st, { 0, 1 });
+    assert(moves.contains(res.row * 3 + res.column));
+  }
+}
+
+// The fork detection used before threat counting. Every pair of plies is played out on a copy of the state and each
+// position is rescanned for wins.
+megatech::ttt::details::cell_set reference_fork_blocks(const megatech::ttt::details::state& st) {
+  const auto count_wins = [](const megatech::ttt::details::state& position, const megatech::ttt::cell_contents mark) {
+    auto res = std::size_t{ 0 };
+    for (const auto cell : position.empty_cells())
+    {
+      res += position.completes_line(cell % 3, cell / 3, mark);
+    }
+    return res;
+  };
+  auto res = megatech::ttt::details::cell_set{ };
+  for (const auto empty : st.empty_cells())
+  {
+    auto next = st;
+    next.cell(empty % 3, empty / 3, megatech::ttt::cell_contents::o);
+    auto fork = false;
+    for (const auto next_empty : next.empty_cells())
+    {
+      auto next_next = next;
+      next_next.cell(next_empty % 3, next_empty / 3, megatech::ttt::cell_contents::x);
+      const auto blocks = next_next.count_x() > 2 ? count_wins(next_next, megatech::ttt::cell_contents::x) : 0;
+      const auto wins = next_next.count_o() > 1 ? count_wins(next_next, megatech::ttt::cell_contents::o) : 0;
+      fork = fork || (blocks > 1 && !wins);
+    }
+    if (!fork)
+    {
+      res.insert(empty);
+    }
+  }
+  return res;
+}
+
+void test_fork_blocks_match_reference() {
+  auto checked = std::size_t{ 0 };
+  visit_reachable([&checked](const megatech::ttt::details::state& st, const megatech::ttt::cell_contents player) {
+    if (player != megatech::ttt::cell_contents::o || st.winner() != megatech::ttt::cell_contents::empty ||
+        st.is_board_full())
+    {
+      return;
+    }
+    assert(static_cast<std::uint32_t>(megatech::ttt::details::fork_blocks(st)) ==
+           static_cast<std::uint32_t>(reference_fork_blocks(st)));
+    ++checked;
+  });
+  assert(checked > 0);
+}
+
 int main() {
-  test_openings();
-  test_win();
-  test_block();
-  test_fork_block();
+  for (const auto algorithm : { megatech::ttt::strategy_algorithm::heuristic,
+                                megatech::ttt::strategy_algorithm::negamax,
+                                megatech::ttt::strategy_algorithm::book })
+  {
+    test_openings(algorithm);
+    test_win(algorithm);
+    test_block(algorithm);
+    test_fork_block(algorithm);
+    test_fork_regression(algorithm);
+  }
+  test_fork_blocks_match_reference();
   return 0;
 }
@@ -0,0 +1,103 @@
+/**
+ * @file strategy_allocations.cpp
+ * @brief Strategy heap allocation test.
+ * @author Alexander Rothman <gnomesort@megate.ch>
+ * @date 2024
+ * @copyright AGPL-3.0+
+ */
+#include <cassert>
+#include <cstddef>
+#include <cstdlib>
+
+#include <new>
+
+#include <megatech/ttt/enums.hpp>
+#include <megatech/ttt/strategy.hpp>
+#include <megatech/ttt/details/state.hpp>
+
+// Every allocation made by the program is counted.
+static std::size_t allocations{ 0 };
+
+void* operator new(const std::size_t size) {
+  ++allocations;
+  if (auto res = std::malloc(size ? size : 1); res)
+  {
+    return res;
+  }
+  throw std::bad_alloc{ };
+}
+
+void* operator new[](const std::size_t size) {
+  return operator new(size);
+}
+
+void operator delete(void *const ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void *const ptr, const std::size_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void *const ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void *const ptr, const std::size_t) noexcept {
+  std::free(ptr);
+}
+
+// Play every X move from the given state and ask the strategy to reply to each. Returns the number of replies.
+std::size_t play_all(const megatech::ttt::strategy& strat, const megatech::ttt::details::state& st) {
+  auto res = std::size_t{ 0 };
+  for (const auto x_cell : st.empty_cells())
+  {
+    auto next = st;
+    const auto last = megatech::ttt::cell_location{ x_cell % 3, x_cell / 3 };
+    next.cell(last.column, last.row, megatech::ttt::cell_contents::x);
+    if (next.winner() != megatech::ttt::cell_contents::empty || next.is_board_full())
+    {
+      continue;
+    }
+    const auto reply = strat.run(next, last);
+    ++res;
+    next.cell(reply.column, reply.row, megatech::ttt::cell_contents::o);
+    if (next.winner() == megatech::ttt::cell_contents::empty && !next.is_board_full())
+    {
+      res += play_all(strat, next);
+    }
+  }
+  return res;
+}
+
+void test_no_allocations(const megatech::ttt::strategy_algorithm algorithm) {
+  const auto strat = megatech::ttt::strategy{ algorithm };
+  const auto before = allocations;
+  const auto replies = play_all(strat, megatech::ttt::details::state{ });
+  assert(replies > 0);
+  assert(allocations == before);
+}
+
+void test_no_table(const megatech::ttt::strategy_algorithm algorithm) {
+  // Only negamax needs a transposition table so the other algorithms must be free to create and copy.
+  const auto before = allocations;
+  const auto strat = megatech::ttt::strategy{ algorithm };
+  auto copy = strat;
+  copy = strat;
+  assert(copy.algorithm() == algorithm);
+  assert(allocations == before);
+}
+
+int main() {
+  // Make sure the hook is actually in use.
+  const auto before = allocations;
+  auto *const volatile ptr = new int{ 0 };
+  delete ptr;
+  assert(allocations == before + 1);
+  test_no_allocations(megatech::ttt::strategy_algorithm::heuristic);
+  test_no_allocations(megatech::ttt::strategy_algorithm::negamax);
+  test_no_allocations(megatech::ttt::strategy_algorithm::book);
+  test_no_table(megatech::ttt::strategy_algorithm::heuristic);
+  test_no_table(megatech::ttt::strategy_algorithm::book);
+  return 0;
+}
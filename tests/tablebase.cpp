@@ -0,0 +1,206 @@
+/**
+ * @file tablebase.cpp
+ * @brief Retrograde analysis tablebase test.
+ * @author Alexander Rothman <gnomesort@megate.ch>
+ * @date 2024
+ * @copyright AGPL-3.0+
+ */
+#include <cassert>
+#include <cstddef>
+#include <cinttypes>
+
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include <megatech/ttt/enums.hpp>
+#include <megatech/ttt/details/lockfile.hpp>
+#include <megatech/ttt/details/rank.hpp>
+#include <megatech/ttt/details/solver.hpp>
+#include <megatech/ttt/details/state.hpp>
+#include <megatech/ttt/details/tablebase.hpp>
+
+#define TABLEBASE_FILE_NAME ("tablebase.ttb")
+
+void test_matches_solver() {
+  megatech::ttt::details::write_tablebase(TABLEBASE_FILE_NAME);
+  const auto tb = megatech::ttt::details::tablebase{ TABLEBASE_FILE_NAME };
+  auto solver = megatech::ttt::details::solver{ };
+  for (auto r = std::size_t{ 0 }; r < megatech::ttt::details::REACHABLE_BOARD_COUNT; ++r)
+  {
+    const auto st = megatech::ttt::details::unrank(r);
+    const auto entry = tb.probe(st);
+    const auto filled = static_cast<int>(st.filled_cells());
+    if (st.winner() != megatech::ttt::cell_contents::empty)
+    {
+      assert(entry.value == megatech::ttt::details::game_value::loss);
+      assert(entry.distance == 0);
+      continue;
+    }
+    if (st.is_board_full())
+    {
+      assert(entry.value == megatech::ttt::details::game_value::draw);
+      assert(entry.distance == 0);
+      continue;
+    }
+    // The solver scores a win that ends with n filled cells as 11 - n.
+    const auto score = solver.evaluate(st);
+    const auto final_score = 11 - (filled + static_cast<int>(entry.distance));
+    switch (entry.value)
+    {
+    case megatech::ttt::details::game_value::win:
+      assert(score == final_score);
+      break;
+    case megatech::ttt::details::game_value::loss:
+      assert(score == -final_score);
+      break;
+    default:
+      assert(score == 0);
+      assert(filled + entry.distance == 9);
+      break;
+    }
+  }
+  const auto empty = tb.probe(megatech::ttt::details::state{ });
+  assert(empty.value == megatech::ttt::details::game_value::draw);
+  assert(empty.distance == 9);
+  std::filesystem::remove_all(TABLEBASE_FILE_NAME);
+}
+
+void test_value_encoding() {
+  megatech::ttt::details::write_tablebase(TABLEBASE_FILE_NAME);
+  const auto with_distance = megatech::ttt::details::tablebase{ TABLEBASE_FILE_NAME };
+  const auto distance_size = std::filesystem::file_size(TABLEBASE_FILE_NAME);
+  megatech::ttt::details::write_tablebase("value.ttb", megatech::ttt::details::tablebase_encoding::value);
+  const auto value_only = megatech::ttt::details::tablebase{ "value.ttb" };
+  assert(with_distance.encoding() == megatech::ttt::details::tablebase_encoding::distance);
+  assert(value_only.encoding() == megatech::ttt::details::tablebase_encoding::value);
+  // Two bits per entry instead of four.
+  const auto header_size = sizeof(megatech::ttt::details::tablebase_header);
+  assert(std::filesystem::file_size("value.ttb") - header_size == (distance_size - header_size + 1) / 2);
+  for (auto r = std::size_t{ 0 }; r < megatech::ttt::details::REACHABLE_BOARD_COUNT; ++r)
+  {
+    const auto st = megatech::ttt::details::unrank(r);
+    const auto expected = with_distance.probe(st);
+    const auto entry = value_only.probe(st);
+    assert(entry.value == expected.value);
+    if (entry.value == megatech::ttt::details::game_value::draw)
+    {
+      assert(entry.distance == expected.distance);
+    }
+    else
+    {
+      assert(entry.distance == megatech::ttt::details::TABLEBASE_UNKNOWN_DISTANCE);
+    }
+  }
+  std::filesystem::remove_all(TABLEBASE_FILE_NAME);
+  std::filesystem::remove_all("value.ttb");
+}
+
+void test_move() {
+  megatech::ttt::details::write_tablebase(TABLEBASE_FILE_NAME);
+  auto tb = megatech::ttt::details::tablebase{ TABLEBASE_FILE_NAME };
+  auto other = std::move(tb);
+  assert(other.probe(megatech::ttt::details::state{ }).value == megatech::ttt::details::game_value::draw);
+  try
+  {
+    tb.probe(megatech::ttt::details::state{ });
+    assert(false);
+  }
+  catch (const std::runtime_error&) { }
+  tb = std::move(other);
+  assert(tb.probe(megatech::ttt::details::state{ }).distance == 9);
+  std::filesystem::remove_all(TABLEBASE_FILE_NAME);
+}
+
+void test_replacement() {
+  std::filesystem::remove_all(TABLEBASE_FILE_NAME);
+  megatech::ttt::details::write_tablebase(TABLEBASE_FILE_NAME);
+  const auto tb = megatech::ttt::details::tablebase{ TABLEBASE_FILE_NAME };
+  // A locked tablebase is never rewritten.
+  {
+    auto lock = megatech::ttt::details::lockfile{ TABLEBASE_FILE_NAME };
+    lock.lock();
+    try
+    {
+      megatech::ttt::details::write_tablebase(TABLEBASE_FILE_NAME, megatech::ttt::details::tablebase_encoding::value);
+      assert(false);
+    }
+    catch (const std::runtime_error&) { }
+  }
+  assert(megatech::ttt::details::tablebase{ TABLEBASE_FILE_NAME }.encoding() ==
+         megatech::ttt::details::tablebase_encoding::distance);
+  // The new file replaces the old one instead of overwriting it so tablebases that are already open are unaffected.
+  megatech::ttt::details::write_tablebase(TABLEBASE_FILE_NAME, megatech::ttt::details::tablebase_encoding::value);
+  assert(megatech::ttt::details::tablebase{ TABLEBASE_FILE_NAME }.encoding() ==
+         megatech::ttt::details::tablebase_encoding::value);
+  assert(tb.encoding() == megatech::ttt::details::tablebase_encoding::distance);
+  assert(tb.probe(megatech::ttt::details::state{ }).distance == 9);
+  assert(!std::filesystem::exists(std::string{ ".~new" }.append(TABLEBASE_FILE_NAME)));
+  assert(!std::filesystem::exists(std::string{ ".~lock" }.append(TABLEBASE_FILE_NAME)));
+  std::filesystem::remove_all(TABLEBASE_FILE_NAME);
+}
+
+void test_invalid_files() {
+  std::filesystem::remove_all(TABLEBASE_FILE_NAME);
+  try
+  {
+    auto tb = megatech::ttt::details::tablebase{ TABLEBASE_FILE_NAME };
+    assert(false);
+  }
+  catch (const std::runtime_error&) { }
+  {
+    auto f_out = std::ofstream{ TABLEBASE_FILE_NAME, std::ios::binary | std::ios::trunc };
+    f_out << "This is not a tablebase file.";
+  }
+  try
+  {
+    auto tb = megatech::ttt::details::tablebase{ TABLEBASE_FILE_NAME };
+    assert(false);
+  }
+  catch (const std::runtime_error&) { }
+  // An unknown encoding or nonzero reserved bytes.
+  for (const auto offset : { offsetof(megatech::ttt::details::tablebase_header, encoding),
+                             offsetof(megatech::ttt::details::tablebase_header, reserved) + 2 })
+  {
+    megatech::ttt::details::write_tablebase(TABLEBASE_FILE_NAME);
+    {
+      auto f_out = std::fstream{ TABLEBASE_FILE_NAME, std::ios::binary | std::ios::in | std::ios::out };
+      f_out.seekp(offset);
+      f_out.put(0x05);
+    }
+    try
+    {
+      auto tb = megatech::ttt::details::tablebase{ TABLEBASE_FILE_NAME };
+      assert(false);
+    }
+    catch (const std::runtime_error&) { }
+  }
+  try
+  {
+    const auto invalid = static_cast<megatech::ttt::details::tablebase_encoding>(7);
+    megatech::ttt::details::write_tablebase(TABLEBASE_FILE_NAME, invalid);
+    assert(false);
+  }
+  catch (const std::runtime_error&) { }
+  // A valid header followed by a truncated table.
+  megatech::ttt::details::write_tablebase(TABLEBASE_FILE_NAME);
+  std::filesystem::resize_file(TABLEBASE_FILE_NAME, sizeof(megatech::ttt::details::tablebase_header) + 16);
+  try
+  {
+    auto tb = megatech::ttt::details::tablebase{ TABLEBASE_FILE_NAME };
+    assert(false);
+  }
+  catch (const std::runtime_error&) { }
+  std::filesystem::remove_all(TABLEBASE_FILE_NAME);
+}
+
+int main() {
+  test_matches_solver();
+  test_value_encoding();
+  test_move();
+  test_replacement();
+  test_invalid_files();
+  return 0;
+}
@@ -0,0 +1,53 @@
+/**
+ * @file test_states.hpp
+ * @brief Game state enumeration helpers shared by the tests.
+ * @author Alexander Rothman <gnomesort@megate.ch>
+ * @date 2024
+ * @copyright AGPL-3.0+
+ */
+#ifndef MEGATECH_TTT_TESTS_TEST_STATES_HPP
+#define MEGATECH_TTT_TESTS_TEST_STATES_HPP
+
+#include <cstddef>
+
+#include <megatech/ttt/enums.hpp>
+#include <megatech/ttt/details/state.hpp>
+
+// Build the state corresponding to a base 3 encoding of the game board. The least significant digit is the upper left
+// cell.
+inline megatech::ttt::details::state state_from_index(std::size_t index) {
+  auto st = megatech::ttt::details::state{ };
+  for (auto i = std::size_t{ 0 }; i < 9; ++i, index /= 3)
+  {
+    st.cell(i % 3, i / 3, static_cast<megatech::ttt::cell_contents>(index % 3));
+  }
+  return st;
+}
+
+// Call visit(st, player) for st and every position that can follow it in a game, where player is the mark to be
+// placed next. Positions reached by more than one sequence of moves are visited once per sequence.
+template <typename Visitor>
+void visit_reachable(const megatech::ttt::details::state& st, const megatech::ttt::cell_contents player,
+                     Visitor&& visit) {
+  visit(st, player);
+  if (st.winner() != megatech::ttt::cell_contents::empty || st.is_board_full())
+  {
+    return;
+  }
+  const auto next_player = player == megatech::ttt::cell_contents::x ? megatech::ttt::cell_contents::o :
+                                                                       megatech::ttt::cell_contents::x;
+  for (const auto cell : st.empty_cells())
+  {
+    auto next = st;
+    next.cell(cell % 3, cell / 3, player);
+    visit_reachable(next, next_player, visit);
+  }
+}
+
+// Call visit(st, player) for every position that can occur in a game.
+template <typename Visitor>
+void visit_reachable(Visitor&& visit) {
+  visit_reachable(megatech::ttt::details::state{ }, megatech::ttt::cell_contents::x, visit);
+}
+
+#endif
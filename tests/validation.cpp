@@ -0,0 +1,114 @@
+/**
+ * @file validation.cpp
+ * @brief Bulk state validation test.
+ * @author Alexander Rothman <gnomesort@megate.ch>
+ * @date 2024
+ * @copyright AGPL-3.0+
+ */
+#include <cassert>
+#include <cstddef>
+#include <cinttypes>
+
+#include <memory>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include <megatech/ttt/details/state.hpp>
+#include <megatech/ttt/details/validation.hpp>
+
+bool constructs(const std::uint32_t data) {
+  try
+  {
+    [[maybe_unused]] const auto st = megatech::ttt::details::state{ data };
+    return true;
+  }
+  catch (const std::runtime_error&)
+  {
+    return false;
+  }
+}
+
+std::vector<std::uint32_t> make_states() {
+  auto res = std::vector<std::uint32_t>{ 0x00'00'00'00, 0x80'00'00'00, 0x40'00'00'00, 0x50'00'00'00, 0x70'00'00'00,
+                                         0xff'ff'ff'ff, 0x00'04'00'00, 0x08'00'00'00, 0x00'03'00'00, 0x00'00'00'03,
+                                         0x00'02'aa'aa, 0x00'01'55'55, 0xc0'02'aa'aa, 0x80'03'ff'ff };
+  // Mostly valid states with a few flipped bits exercise each rule independently.
+  auto rng = std::mt19937{ 12345 };
+  auto board = std::uniform_int_distribution<std::uint32_t>{ 0, 0x00'03'ff'ff };
+  auto phase = std::uniform_int_distribution<std::uint32_t>{ 0, 7 };
+  auto bit = std::uniform_int_distribution<std::uint32_t>{ 0, 31 };
+  for (auto i = std::size_t{ 0 }; i < 100'000; ++i)
+  {
+    auto data = (board(rng) & 0x00'02'aa'aa) | (phase(rng) << 28);
+    if (i % 3 == 0)
+    {
+      data ^= std::uint32_t{ 1 } << bit(rng);
+    }
+    res.push_back(data);
+  }
+  return res;
+}
+
+void test_matches_constructor() {
+  const auto states = make_states();
+  auto results = std::make_unique<bool[]>(states.size());
+  auto expected_invalid = std::size_t{ 0 };
+  for (const auto data : states)
+  {
+    assert(megatech::ttt::details::is_valid_state(data) == constructs(data));
+    expected_invalid += !constructs(data);
+  }
+  const auto invalid = megatech::ttt::details::validate_states(states, { results.get(), states.size() });
+  assert(invalid == expected_invalid);
+  assert(invalid > 0 && invalid < states.size());
+  for (auto i = std::size_t{ 0 }; i < states.size(); ++i)
+  {
+    assert(results[i] == constructs(states[i]));
+  }
+}
+
+void test_partial_spans() {
+  const auto states = make_states();
+  auto results = std::make_unique<bool[]>(states.size());
+  // Unaligned starts and lengths that aren't multiples of the vector width must produce the same results.
+  for (auto offset = std::size_t{ 0 }; offset < 9; ++offset)
+  {
+    for (auto length = std::size_t{ 0 }; length < 20; ++length)
+    {
+      const auto input = std::span<const std::uint32_t>{ states.data() + offset, length };
+      auto expected_invalid = std::size_t{ 0 };
+      for (const auto data : input)
+      {
+        expected_invalid += !constructs(data);
+      }
+      assert(megatech::ttt::details::validate_states(input, { results.get(), length }) == expected_invalid);
+      for (auto i = std::size_t{ 0 }; i < length; ++i)
+      {
+        assert(results[i] == constructs(input[i]));
+      }
+    }
+  }
+  // Spans of different sizes are rejected without writing any results.
+  results[0] = false;
+  try
+  {
+    megatech::ttt::details::validate_states({ states.data(), 8 }, { results.get(), 4 });
+    assert(false);
+  }
+  catch (const std::runtime_error&) { }
+  try
+  {
+    megatech::ttt::details::validate_states({ }, { results.get(), 4 });
+    assert(false);
+  }
+  catch (const std::runtime_error&) { }
+  assert(!results[0]);
+}
+
+int main() {
+  test_matches_constructor();
+  test_partial_spans();
+  return 0;
+}
@@ -0,0 +1,63 @@
+/**
+ * @file verifier.cpp
+ * @brief Exhaustive strategy verification test.
+ * @author Alexander Rothman <gnomesort@megate.ch>
+ * @date 2024
+ * @copyright AGPL-3.0+
+ */
+#include <cassert>
+#include <cstddef>
+#include <cinttypes>
+
+#include <stdexcept>
+
+#include <megatech/ttt/strategy.hpp>
+#include <megatech/ttt/details/verifier.hpp>
+
+void test_never_loses(const megatech::ttt::strategy_algorithm algorithm) {
+  for (const auto seed : { std::uint64_t{ 0 }, std::uint64_t{ 1 } })
+  {
+    for (const auto threads : { std::size_t{ 1 }, std::size_t{ 4 } })
+    {
+      const auto res = megatech::ttt::details::verify_strategy(algorithm, seed, threads);
+      assert(res.x_wins == 0);
+      assert(!res.loss);
+      assert(res.games == res.x_wins + res.o_wins + res.draws);
+      assert(res.nodes > res.games);
+    }
+  }
+}
+
+void test_deterministic_node_count(const megatech::ttt::strategy_algorithm algorithm) {
+  // Every move a strategy could choose is followed, so the tree must be identical regardless of the seed or how it is
+  // split.
+  const auto expected = megatech::ttt::details::verify_strategy(algorithm, 0, 1);
+  for (const auto threads : { std::size_t{ 2 }, std::size_t{ 3 }, std::size_t{ 8 } })
+  {
+    const auto res = megatech::ttt::details::verify_strategy(algorithm, threads * 7, threads);
+    assert(res.nodes == expected.nodes);
+    assert(res.games == expected.games);
+    assert(res.o_wins == expected.o_wins);
+    assert(res.draws == expected.draws);
+  }
+}
+
+void test_no_threads() {
+  try
+  {
+    megatech::ttt::details::verify_strategy(megatech::ttt::strategy_algorithm::book, 0, 0);
+    assert(false);
+  }
+  catch (const std::runtime_error&) { }
+}
+
+int main() {
+  test_never_loses(megatech::ttt::strategy_algorithm::heuristic);
+  test_never_loses(megatech::ttt::strategy_algorithm::negamax);
+  test_never_loses(megatech::ttt::strategy_algorithm::book);
+  test_deterministic_node_count(megatech::ttt::strategy_algorithm::heuristic);
+  test_deterministic_node_count(megatech::ttt::strategy_algorithm::negamax);
+  test_deterministic_node_count(megatech::ttt::strategy_algorithm::book);
+  test_no_threads();
+  return 0;
+}